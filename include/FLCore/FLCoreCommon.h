@@ -3878,6 +3878,15 @@ public:
 	uint iOwner;
 };
 
+// EquipDesc has a trivial destructor and holds no pointers into itself, so st6::vector<EquipDesc> can grow with memcpy
+namespace st6
+{
+	template<>
+	struct is_trivially_relocatable<EquipDesc> : std::true_type
+	{
+	};
+};
+
 class IMPORT EquipDescList
 {
 public:
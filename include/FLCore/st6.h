@@ -6,8 +6,23 @@
 #endif
 
 #include <cstddef>
+#include <cstring>
+#include <new>
 #include <stdexcept>
 #include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// as_span() needs C++20; the rest of st6.h builds as C++17
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+	#include <span>
+#endif
+
+#if !defined(ST6_NO_SIMD) && (defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__))
+	#define ST6_SSE2
+	#include <emmintrin.h>
+#endif
 
 #ifndef _DESTRUCTOR
 	#define _DESTRUCTOR(ty, ptr) (ptr)->~ty()
@@ -44,10 +59,17 @@ namespace st6
 		_DESTRUCTOR(_Ty, _P);
 	}
 
-	inline void _Destroy(char* _P)
+	// Types which may be moved to new storage with a plain memcpy, without running any constructor or destructor.
+	// Specialize for types which hold no pointers into themselves and are not tracked by address elsewhere.
+	template<class _Ty>
+	struct is_trivially_relocatable : std::is_trivially_copyable<_Ty>
+	{
+	};
+
+	inline void _Destroy(char*)
 	{
 	}
-	inline void _Destroy(wchar_t* _P)
+	inline void _Destroy(wchar_t*)
 	{
 	}
 
@@ -67,10 +89,16 @@ namespace st6
 		pointer allocate(size_type _N, const void*) { return (_Allocate((difference_type)_N, (pointer)0)); }
 
 		char* _Charalloc(size_type _N) { return (_Allocate((difference_type)_N, (char*)0)); }
+		void _Chardealloc(void* _P, size_type) { st6_free(_P); }
 
 		void deallocate(void* _P, size_type) { st6_free(_P); }
 		void construct(pointer _P, const _Ty& _V) { _Construct(_P, _V); }
-		void destroy(pointer _P) { _Destroy(_P); }
+		template<class... _Args>
+		void construct(pointer _P, _Args&&... _Vals)
+		{
+			new ((void*)_P) _Ty(std::forward<_Args>(_Vals)...);
+		}
+		void destroy(pointer _P) { st6::_Destroy(_P); }
 
 		size_t max_size() const
 		{
@@ -101,6 +129,237 @@ namespace st6
 		typedef _Ty value_type;
 	};
 
+	// Allocation counters kept per thread by _Node_pool and tick_arena.
+	struct alloc_counters
+	{
+		size_t allocs = 0;         // blocks handed out
+		size_t frees = 0;          // blocks given back
+		size_t backing_allocs = 0; // st6_malloc calls made to serve them
+		ptrdiff_t bytes = 0;       // bytes currently handed out, net of blocks freed here but allocated elsewhere
+		ptrdiff_t peak_bytes = 0;
+	};
+
+	// Per-thread cache of freed blocks, bucketed by size rounded up to whole pointers, and allocated at that rounded
+	// size. Blocks are still individual st6_malloc allocations, so a node may be freed by Freelancer through st6_free.
+	// List and map nodes are always a whole number of pointers, so a node allocated by Freelancer may also end up in
+	// the cache.
+	class _Node_pool
+	{
+	  public:
+		enum
+		{
+			_MAX_SLOTS = 64,
+			_MAX_CACHED = 1024
+		};
+		static _Node_pool& _Get()
+		{
+			static thread_local _Node_pool _Pool;
+			return (_Pool);
+		}
+		// The main thread's pool is destroyed before objects with static lifetime, so containers which outlive it
+		// allocate and free straight through st6_malloc/st6_free.
+		static void* _Palloc(size_t _N) { return (_Torndown() ? st6_malloc(_N) : _Get()._Alloc(_N)); }
+		static void _Pfree(void* _P, size_t _N)
+		{
+			if (_Torndown())
+				st6_free(_P);
+			else
+				_Get()._Dealloc(_P, _N);
+		}
+		~_Node_pool()
+		{
+			_Torndown() = true;
+			for (size_t _I = 0; _I < _MAX_SLOTS; ++_I)
+				while (_Free[_I] != 0)
+				{
+					void* _P = _Free[_I];
+					_Free[_I] = *(void**)_P;
+					st6_free(_P);
+				}
+		}
+		void* _Alloc(size_t _N)
+		{
+			size_t _I = _Slot(_N);
+			if (_I < _MAX_SLOTS && _Free[_I] != 0)
+			{
+				void* _P = _Free[_I];
+				_Free[_I] = *(void**)_P;
+				--_Count[_I];
+				_Counted(_N);
+				return (_P);
+			}
+			++_Stats.backing_allocs;
+			_Counted(_N);
+			return (st6_malloc(_I < _MAX_SLOTS ? _I * sizeof(void*) : _N));
+		}
+		void _Dealloc(void* _P, size_t _N)
+		{
+			size_t _I = _Slot(_N);
+			if (_P != 0)
+				++_Stats.frees, _Stats.bytes -= (ptrdiff_t)_N;
+			if (_P == 0)
+				;
+			else if (_I < _MAX_SLOTS && _Count[_I] < _MAX_CACHED)
+			{
+				*(void**)_P = _Free[_I];
+				_Free[_I] = _P;
+				++_Count[_I];
+			}
+			else
+				st6_free(_P);
+		}
+
+		const alloc_counters& counters() const { return (_Stats); }
+
+	  private:
+		static bool& _Torndown()
+		{
+			static thread_local bool _Flag = false;
+			return (_Flag);
+		}
+		static size_t _Slot(size_t _N)
+		{
+			size_t _I = (_N + sizeof(void*) - 1) / sizeof(void*);
+			return (_N != 0 && _I < _MAX_SLOTS ? _I : (size_t)_MAX_SLOTS);
+		}
+		void _Counted(size_t _N)
+		{
+			++_Stats.allocs;
+			if (_Stats.peak_bytes < (_Stats.bytes += (ptrdiff_t)_N))
+				_Stats.peak_bytes = _Stats.bytes;
+		}
+		void* _Free[_MAX_SLOTS] = {};
+		size_t _Count[_MAX_SLOTS] = {};
+		alloc_counters _Stats;
+	};
+
+	// Opt-in allocator for st6::list and st6::map which recycles nodes through _Node_pool instead of calling
+	// st6_malloc/st6_free for every insert and erase. Element arrays (vector, string) are allocated as usual.
+	template<class _Ty>
+	class node_allocator : public allocator<_Ty>
+	{
+	  public:
+		typedef typename allocator<_Ty>::size_type size_type;
+		char* _Charalloc(size_type _N) { return ((char*)_Node_pool::_Palloc(_N)); }
+		void _Chardealloc(void* _P, size_type _N) { _Node_pool::_Pfree(_P, _N); }
+	};
+
+	// node_allocator which also pools small element arrays of st6::vector and st6::basic_string. Blocks of
+	// _Node_pool::_MAX_SLOTS pointers or more pass straight through to st6_malloc/st6_free.
+	template<class _Ty>
+	class pool_allocator : public node_allocator<_Ty>
+	{
+	  public:
+		typedef typename allocator<_Ty>::size_type size_type;
+		typedef typename allocator<_Ty>::pointer pointer;
+		pointer allocate(size_type _N, const void*) { return ((pointer)_Node_pool::_Palloc(_N * sizeof(_Ty))); }
+		void deallocate(void* _P, size_type _N) { _Node_pool::_Pfree(_P, _N * sizeof(_Ty)); }
+	};
+
+	// Per-thread bump allocator for containers which live no longer than one server tick. Freeing is a no-op;
+	// all memory is reclaimed at once by reset(), which keeps the chunks for the next tick. Containers using it must
+	// be destroyed before reset() and must never be handed to Server.dll or any other game code, which would free
+	// their blocks through st6_free. Use the default st6::allocator for those.
+	class tick_arena
+	{
+	  public:
+		enum
+		{
+			_CHUNK_SIZE = 64 * 1024,
+			_ALIGN = alignof(std::max_align_t)
+		};
+		static tick_arena& get()
+		{
+			static thread_local tick_arena _Arena;
+			return (_Arena);
+		}
+		~tick_arena() { release(); }
+		void* _Alloc(size_t _N)
+		{
+			_N = (_N + _ALIGN - 1) & ~(size_t)(_ALIGN - 1);
+			if (_Cur == 0 || _Cur->_Size - _Used < _N)
+				_Nextchunk(_N);
+			void* _P = (char*)(_Cur + 1) + _Used;
+			_Used += _N;
+			++_Stats.allocs;
+			if (_Stats.peak_bytes < (_Stats.bytes += (ptrdiff_t)_N))
+				_Stats.peak_bytes = _Stats.bytes;
+			return (_P);
+		}
+		void _Dealloc(void* _P, size_t)
+		{
+			if (_P != 0)
+				++_Stats.frees;
+		}
+		// Rewinds to the first chunk, invalidating everything allocated since the last reset.
+		void reset()
+		{
+			_Cur = _First;
+			_Used = 0;
+			_Stats.bytes = 0;
+		}
+		// Returns all chunks to st6_free.
+		void release()
+		{
+			while (_First != 0)
+			{
+				_Chunk* _C = _First;
+				_First = _C->_Next;
+				st6_free(_C);
+			}
+			_Cur = 0;
+			_Used = 0;
+			_Stats.bytes = 0;
+		}
+		const alloc_counters& counters() const { return (_Stats); }
+
+	  private:
+		struct alignas(std::max_align_t) _Chunk
+		{
+			_Chunk* _Next;
+			size_t _Size;
+		};
+		void _Nextchunk(size_t _N)
+		{
+			_Chunk* _Prev = _Cur;
+			_Chunk* _C = _Cur == 0 ? _First : _Cur->_Next;
+			if (_C == 0 || _C->_Size < _N)
+			{
+				size_t _Size = _N < _CHUNK_SIZE ? (size_t)_CHUNK_SIZE : _N;
+				_C = (_Chunk*)st6_malloc(sizeof(_Chunk) + _Size);
+				if (_C == 0)
+					throw std::bad_alloc();
+				++_Stats.backing_allocs;
+				_C->_Size = _Size;
+				_C->_Next = _Prev == 0 ? _First : _Prev->_Next;
+				if (_Prev == 0)
+					_First = _C;
+				else
+					_Prev->_Next = _C;
+			}
+			_Cur = _C;
+			_Used = 0;
+		}
+		_Chunk* _First = 0;
+		_Chunk* _Cur = 0;
+		size_t _Used = 0;
+		alloc_counters _Stats;
+	};
+
+	// Allocator routing every st6 container allocation through tick_arena, e.g.
+	// st6::list<XCollision, st6::arena_allocator<XCollision>> for a per-tick collision group list.
+	template<class _Ty>
+	class arena_allocator : public allocator<_Ty>
+	{
+	  public:
+		typedef typename allocator<_Ty>::size_type size_type;
+		typedef typename allocator<_Ty>::pointer pointer;
+		pointer allocate(size_type _N, const void*) { return ((pointer)tick_arena::get()._Alloc(_N * sizeof(_Ty))); }
+		void deallocate(void* _P, size_type _N) { tick_arena::get()._Dealloc(_P, _N * sizeof(_Ty)); }
+		char* _Charalloc(size_type _N) { return ((char*)tick_arena::get()._Alloc(_N)); }
+		void _Chardealloc(void* _P, size_type _N) { tick_arena::get()._Dealloc(_P, _N); }
+	};
+
 	template<class _Ty, class _A = allocator<_Ty>>
 	class vector
 	{
@@ -134,9 +393,21 @@ namespace st6
 			_End = _Last;
 		}
 
+		vector(_Myt&& _X) noexcept : allocator(_X.allocator), _First(_X._First), _Last(_X._Last), _End(_X._End) { _X._First = 0, _X._Last = 0, _X._End = 0; }
+
 		typedef const_iterator _It;
 
-		vector(_It _F, _It _L, const _A& _Al = _A()) : allocator(_Al), _First(0), _Last(0), _End(0) { insert(begin(), _F, _L); }
+		vector(_It _F, _It _L, const _A& _Al = _A()) : allocator(_Al), _First(0), _Last(0), _End(0)
+		{
+			size_type _N = 0;
+			_Distance(_F, _L, _N);
+			if (0 < _N)
+			{
+				_First = allocator.allocate(_N, (void*)0);
+				_Last = _Ucopy(_F, _L, _First);
+				_End = _Last;
+			}
+		}
 
 		~vector()
 		{
@@ -173,16 +444,30 @@ namespace st6
 			return (*this);
 		}
 
+		_Myt& operator=(_Myt&& _X) noexcept
+		{
+			if (this == &_X)
+				;
+			else if (allocator == _X.allocator)
+			{
+				_Destroy(_First, _Last);
+				allocator.deallocate(_First, _End - _First);
+				_First = _X._First, _Last = _X._Last, _End = _X._End;
+				_X._First = 0, _X._Last = 0, _X._End = 0;
+			}
+			else
+				*this = static_cast<const _Myt&>(_X);
+			return (*this);
+		}
+
 		void reserve(size_type _N)
 		{
 			if (capacity() < _N)
 			{
 				iterator _S = allocator.allocate(_N, (void*)0);
-				_Ucopy(_First, _Last, _S);
-				_Destroy(_First, _Last);
+				_Last = _Urelocate(_First, _Last, _S);
 				allocator.deallocate(_First, _End - _First);
 				_End = _S + _N;
-				_Last = _S + size();
 				_First = _S;
 			}
 		}
@@ -226,7 +511,22 @@ namespace st6
 		const_reference front() const { return (*begin()); }
 		reference back() { return (*(end() - 1)); }
 		const_reference back() const { return (*(end() - 1)); }
-		void push_back(const _Ty& _X) { insert(end(), _X); }
+		void push_back(const _Ty& _X) { emplace_back(_X); }
+		void push_back(_Ty&& _X) { emplace_back(std::move(_X)); }
+
+		template<class... _Args>
+		reference emplace_back(_Args&&... _Vals)
+		{
+			if (_Last == _End)
+				_Emplace_grow(_Last, std::forward<_Args>(_Vals)...);
+			else
+			{
+				allocator.construct(_Last, std::forward<_Args>(_Vals)...);
+				++_Last;
+			}
+			return (back());
+		}
+
 		void pop_back() { erase(end() - 1); }
 
 		void assign(_It _F, _It _L)
@@ -248,33 +548,58 @@ namespace st6
 			return (begin() + _O);
 		}
 
+		iterator insert(iterator _P, _Ty&& _X) { return (emplace(_P, std::move(_X))); }
+
+		template<class... _Args>
+		iterator emplace(iterator _P, _Args&&... _Vals)
+		{
+			size_type _O = _P - begin();
+			if (_Last == _End)
+				_Emplace_grow(_P, std::forward<_Args>(_Vals)...);
+			else if (_P == _Last)
+			{
+				allocator.construct(_Last, std::forward<_Args>(_Vals)...);
+				++_Last;
+			}
+			else
+			{
+				_Ty _Tmp(std::forward<_Args>(_Vals)...);
+				allocator.construct(_Last, std::move(*(_Last - 1)));
+				_Move_backward(_P, _Last - 1, _Last);
+				*_P = std::move(_Tmp);
+				++_Last;
+			}
+			return (begin() + _O);
+		}
+
 		void insert(iterator _P, size_type _M, const _Ty& _X)
 		{
 			if (static_cast<uint>(_End - _Last) < _M)
 			{
 				size_type _N = size() + (_M < size() ? size() : _M);
 				iterator _S = allocator.allocate(_N, (void*)0);
-				iterator _Q = _Ucopy(_First, _P, _S);
+				iterator _Q = _S + (_P - _First);
 				_Ufill(_Q, _M, _X);
-				_Ucopy(_P, _Last, _Q + _M);
-				_Destroy(_First, _Last);
+				_Urelocate(_First, _P, _S);
+				_Last = _Urelocate(_P, _Last, _Q + _M);
 				allocator.deallocate(_First, _End - _First);
 				_End = _S + _N;
-				_Last = _S + size() + _M;
 				_First = _S;
 			}
 			else if (static_cast<uint>(_Last - _P) < _M)
 			{
-				_Ucopy(_P, _Last, _P + _M);
+				// Fill the new tail first, _X may refer to an element that is about to be moved
 				_Ufill(_Last, _M - (_Last - _P), _X);
-				//fill(_P, _Last, _X);
+				_Umove(_P, _Last, _P + _M);
+				_Fill(_P, _Last, *_Last);
 				_Last += _M;
 			}
 			else if (0 < _M)
 			{
-				_Ucopy(_Last - _M, _Last, _Last);
-				//copy_backward(_P, _Last - _M, _Last);
-				//fill(_P, _P + _M, _X);
+				_Ty _Tmp = _X;
+				_Umove(_Last - _M, _Last, _Last);
+				_Move_backward(_P, _Last - _M, _Last);
+				_Fill(_P, _P + _M, _Tmp);
 				_Last += _M;
 			}
 		}
@@ -283,20 +608,19 @@ namespace st6
 		{
 			size_type _M = 0;
 			_Distance(_F, _L, _M);
-			if (_End - _Last < _M)
+			if (static_cast<size_type>(_End - _Last) < _M)
 			{
 				size_type _N = size() + (_M < size() ? size() : _M);
 				iterator _S = allocator.allocate(_N, (void*)0);
-				iterator _Q = _Ucopy(_First, _P, _S);
-				_Q = _Ucopy(_F, _L, _Q);
-				_Ucopy(_P, _Last, _Q);
-				_Destroy(_First, _Last);
+				iterator _Q = _S + (_P - _First);
+				_Ucopy(_F, _L, _Q);
+				_Urelocate(_First, _P, _S);
+				_Last = _Urelocate(_P, _Last, _Q + _M);
 				allocator.deallocate(_First, _End - _First);
 				_End = _S + _N;
-				_Last = _S + size() + _M;
 				_First = _S;
 			}
-			else if (_Last - _P < _M)
+			else if (static_cast<size_type>(_Last - _P) < _M)
 			{
 				_Ucopy(_P, _Last, _P + _M);
 				_Ucopy(_F + (_Last - _P), _L, _Last);
@@ -371,6 +695,57 @@ namespace st6
 				allocator.construct(_F, _X);
 		}
 
+		iterator _Umove(iterator _F, iterator _L, iterator _P)
+		{
+			for (; _F != _L; ++_P, ++_F)
+				allocator.construct(_P, std::move(*_F));
+			return (_P);
+		}
+
+		// Moves [_F, _L) into raw storage at _P and ends the lifetime of the source elements
+		iterator _Urelocate(iterator _F, iterator _L, iterator _P)
+		{
+			if constexpr (is_trivially_relocatable<_Ty>::value)
+			{
+				if (_F != _L)
+					std::memcpy((void*)_P, (const void*)_F, (_L - _F) * sizeof(_Ty));
+				return (_P + (_L - _F));
+			}
+			else
+			{
+				for (iterator _S = _F; _S != _L; ++_P, ++_S)
+					allocator.construct(_P, std::move_if_noexcept(*_S));
+				_Destroy(_F, _L);
+				return (_P);
+			}
+		}
+
+		static void _Move_backward(iterator _F, iterator _L, iterator _P)
+		{
+			while (_F != _L)
+				*--_P = std::move(*--_L);
+		}
+
+		static void _Fill(iterator _F, iterator _L, const _Ty& _X)
+		{
+			for (; _F != _L; ++_F)
+				*_F = _X;
+		}
+
+		template<class... _Args>
+		void _Emplace_grow(iterator _P, _Args&&... _Vals)
+		{
+			size_type _N = size() + (size() < 1 ? 1 : size());
+			iterator _S = allocator.allocate(_N, (void*)0);
+			iterator _Q = _S + (_P - _First);
+			allocator.construct(_Q, std::forward<_Args>(_Vals)...);
+			_Urelocate(_First, _P, _S);
+			_Last = _Urelocate(_P, _Last, _Q + 1);
+			allocator.deallocate(_First, _End - _First);
+			_End = _S + _N;
+			_First = _S;
+		}
+
 		void _Xran() const { _THROW2(std::out_of_range, "invalid vector<T> subscript"); }
 
 		_A allocator;
@@ -429,6 +804,11 @@ namespace st6
 		class const_iterator
 		{
 		  public:
+			typedef std::bidirectional_iterator_tag iterator_category;
+			typedef _Ty value_type;
+			typedef typename _A::difference_type difference_type;
+			typedef _Ctptr pointer;
+			typedef const_reference reference;
 			const_iterator() {}
 			const_iterator(_Nodeptr _P) : _Ptr(_P) {}
 			const_iterator(const iterator& _X) : _Ptr(_X._Ptr) {}
@@ -462,7 +842,7 @@ namespace st6
 			{
 				if (_Color(_Ptr) == _Red && _Parent(_Parent(_Ptr)) == _Ptr)
 					_Ptr = _Right(_Ptr);
-				else if (_Left(_Ptr) != _Nil)
+				else if (_Left(_Ptr) != _Nil())
 					_Ptr = _Max(_Left(_Ptr));
 				else
 				{
@@ -474,7 +854,7 @@ namespace st6
 			}
 			void _Inc()
 			{
-				if (_Right(_Ptr) != _Nil)
+				if (_Right(_Ptr) != _Nil())
 					_Ptr = _Min(_Right(_Ptr));
 				else
 				{
@@ -495,6 +875,8 @@ namespace st6
 		class iterator : public const_iterator
 		{
 		  public:
+			typedef _Tptr pointer;
+			typedef _REFERENCE_X(_Ty, _A) reference;
 			iterator() {}
 			iterator(_Nodeptr _P) : const_iterator(_P) {}
 			reference operator*() const { return (_Value(this->_Ptr)); }
@@ -543,13 +925,6 @@ namespace st6
 			erase(begin(), end());
 			_Freenode(_Head);
 			_Head = 0, _Size = 0;
-			{
-				if (--_Nilrefs == 0)
-				{
-					_Freenode(_Nil);
-					_Nil = 0;
-				}
-			}
 		}
 		_Myt& operator=(const _Myt& _X)
 		{
@@ -568,6 +943,24 @@ namespace st6
 		size_type size() const { return (_Size); }
 		size_type max_size() const { return (allocator.max_size()); }
 		bool empty() const { return (size() == 0); }
+		// Checks the red-black invariants, parent links, key order, size and the leftmost/rightmost links in O(n).
+		// Meant for debug builds and tests; returns false if the tree is corrupt.
+		bool _Verify() const
+		{
+			if (_Color(_Nil()) != _Black || _Left(_Nil()) != 0 || _Parent(_Nil()) != 0 || _Right(_Nil()) != 0)
+				return (false);
+			if (_Root() == _Nil())
+				return (_Size == 0 && _Lmost() == _Head && _Rmost() == _Head);
+			if (_Color(_Root()) != _Black || _Parent(_Root()) != _Head || _Lmost() != _Min(_Root()) || _Rmost() != _Max(_Root()))
+				return (false);
+			if (_Verify(_Root()) == 0)
+				return (false);
+			size_type _N = 1;
+			for (const_iterator _P = begin(), _Q = _P; ++_Q != end(); _P = _Q, ++_N)
+				if (_Multi ? key_compare(_Kfn()(*_Q), _Kfn()(*_P)) : !key_compare(_Kfn()(*_P), _Kfn()(*_Q)))
+					return (false);
+			return (_N == _Size);
+		}
 		_A get_allocator() const { return (allocator); }
 		_Pr key_comp() const { return (key_compare); }
 		_Pairib insert(const value_type& _V)
@@ -576,7 +969,7 @@ namespace st6
 			_Nodeptr _Y = _Head;
 			bool _Ans = true;
 			{
-				while (_X != _Nil)
+				while (_X != _Nil())
 				{
 					_Y = _X;
 					_Ans = key_compare(_Kfn()(_V), _Key(_X));
@@ -608,39 +1001,60 @@ namespace st6
 			else if (_P == end())
 			{
 				if (key_compare(_Key(_Rmost()), _Kfn()(_V)))
-					return (_Insert(_Nil, _Rmost(), _V));
+					return (_Insert(_Nil(), _Rmost(), _V));
 			}
+			else if (_P._Mynode() == _Rmost() && key_compare(_Key(_Rmost()), _Kfn()(_V)))
+				// Hint is the result of the previous insert of an ascending sequence; stepping from the rightmost node
+				// either way would climb the right spine
+				return (_Insert(_Nil(), _Rmost(), _V));
 			else
 			{
 				iterator _Pb = _P;
 				if (key_compare(_Key((--_Pb)._Mynode()), _Kfn()(_V)) && key_compare(_Kfn()(_V), _Key(_P._Mynode())))
 				{
-					if (_Right(_Pb._Mynode()) == _Nil)
-						return (_Insert(_Nil, _Pb._Mynode(), _V));
+					if (_Right(_Pb._Mynode()) == _Nil())
+						return (_Insert(_Nil(), _Pb._Mynode(), _V));
 					else
 						return (_Insert(_Head, _P._Mynode(), _V));
 				}
 			}
+			if (size() != 0 && _P != end() && key_compare(_Key(_P._Mynode()), _Kfn()(_V)))
+			{
+				// Hint is the element just before _V; costs one in-order step from the hint
+				iterator _Pn = _P;
+				if (++_Pn == end() || key_compare(_Kfn()(_V), _Key(_Pn._Mynode())))
+				{
+					if (_Right(_P._Mynode()) == _Nil())
+						return (_Insert(_Nil(), _P._Mynode(), _V));
+					else
+						return (_Insert(_Head, _Pn._Mynode(), _V));
+				}
+			}
 			return (insert(_V).first);
 		}
 		void insert(iterator _F, iterator _L)
 		{
+			// Ranges of another tree are sorted, so the end() hint makes each insert amortized O(1)
 			for (; _F != _L; ++_F)
-				insert(*_F);
+				insert(end(), *_F);
 		}
 		void insert(const value_type* _F, const value_type* _L)
 		{
-			for (; _F != _L; ++_F)
-				insert(*_F);
+			if (size() == 0 && _Sorted(_F, _L))
+				_Build(_F, _L);
+			else
+				for (; _F != _L; ++_F)
+					insert(end(), *_F);
 		}
 		iterator erase(iterator _P)
 		{
 			_Nodeptr _X;
+			_Nodeptr _Xpar;
 			_Nodeptr _Y = (_P++)._Mynode();
 			_Nodeptr _Z = _Y;
-			if (_Left(_Y) == _Nil)
+			if (_Left(_Y) == _Nil())
 				_X = _Right(_Y);
-			else if (_Right(_Y) == _Nil)
+			else if (_Right(_Y) == _Nil())
 				_X = _Left(_Y);
 			else
 				_Y = _Min(_Right(_Y)), _X = _Right(_Y);
@@ -649,11 +1063,13 @@ namespace st6
 				_Parent(_Left(_Z)) = _Y;
 				_Left(_Y) = _Left(_Z);
 				if (_Y == _Right(_Z))
-					_Parent(_X) = _Y;
+					_Xpar = _Y;
 				else
 				{
-					_Parent(_X) = _Parent(_Y);
-					_Left(_Parent(_Y)) = _X;
+					_Xpar = _Parent(_Y);
+					if (_X != _Nil())
+						_Parent(_X) = _Xpar;
+					_Left(_Xpar) = _X;
 					_Right(_Y) = _Right(_Z);
 					_Parent(_Right(_Z)) = _Y;
 				}
@@ -669,7 +1085,9 @@ namespace st6
 			}
 			else
 			{
-				_Parent(_X) = _Parent(_Y);
+				_Xpar = _Parent(_Y);
+				if (_X != _Nil())
+					_Parent(_X) = _Xpar;
 				if (_Root() == _Z)
 					_Root() = _X;
 				else if (_Left(_Parent(_Z)) == _Z)
@@ -678,13 +1096,13 @@ namespace st6
 					_Right(_Parent(_Z)) = _X;
 				if (_Lmost() != _Z)
 					;
-				else if (_Right(_Z) == _Nil)
+				else if (_Right(_Z) == _Nil())
 					_Lmost() = _Parent(_Z);
 				else
 					_Lmost() = _Min(_X);
 				if (_Rmost() != _Z)
 					;
-				else if (_Left(_Z) == _Nil)
+				else if (_Left(_Z) == _Nil())
 					_Rmost() = _Parent(_Z);
 				else
 					_Rmost() = _Max(_X);
@@ -692,20 +1110,21 @@ namespace st6
 			if (_Color(_Y) == _Black)
 			{
 				while (_X != _Root() && _Color(_X) == _Black)
-					if (_X == _Left(_Parent(_X)))
+					if (_X == _Left(_Xpar))
 					{
-						_Nodeptr _W = _Right(_Parent(_X));
+						_Nodeptr _W = _Right(_Xpar);
 						if (_Color(_W) == _Red)
 						{
 							_Color(_W) = _Black;
-							_Color(_Parent(_X)) = _Red;
-							_Lrotate(_Parent(_X));
-							_W = _Right(_Parent(_X));
+							_Color(_Xpar) = _Red;
+							_Lrotate(_Xpar);
+							_W = _Right(_Xpar);
 						}
 						if (_Color(_Left(_W)) == _Black && _Color(_Right(_W)) == _Black)
 						{
 							_Color(_W) = _Red;
-							_X = _Parent(_X);
+							_X = _Xpar;
+							_Xpar = _Parent(_X);
 						}
 						else
 						{
@@ -714,29 +1133,30 @@ namespace st6
 								_Color(_Left(_W)) = _Black;
 								_Color(_W) = _Red;
 								_Rrotate(_W);
-								_W = _Right(_Parent(_X));
+								_W = _Right(_Xpar);
 							}
-							_Color(_W) = _Color(_Parent(_X));
-							_Color(_Parent(_X)) = _Black;
+							_Color(_W) = _Color(_Xpar);
+							_Color(_Xpar) = _Black;
 							_Color(_Right(_W)) = _Black;
-							_Lrotate(_Parent(_X));
+							_Lrotate(_Xpar);
 							break;
 						}
 					}
 					else
 					{
-						_Nodeptr _W = _Left(_Parent(_X));
+						_Nodeptr _W = _Left(_Xpar);
 						if (_Color(_W) == _Red)
 						{
 							_Color(_W) = _Black;
-							_Color(_Parent(_X)) = _Red;
-							_Rrotate(_Parent(_X));
-							_W = _Left(_Parent(_X));
+							_Color(_Xpar) = _Red;
+							_Rrotate(_Xpar);
+							_W = _Left(_Xpar);
 						}
 						if (_Color(_Right(_W)) == _Black && _Color(_Left(_W)) == _Black)
 						{
 							_Color(_W) = _Red;
-							_X = _Parent(_X);
+							_X = _Xpar;
+							_Xpar = _Parent(_X);
 						}
 						else
 						{
@@ -745,16 +1165,17 @@ namespace st6
 								_Color(_Right(_W)) = _Black;
 								_Color(_W) = _Red;
 								_Lrotate(_W);
-								_W = _Left(_Parent(_X));
+								_W = _Left(_Xpar);
 							}
-							_Color(_W) = _Color(_Parent(_X));
-							_Color(_Parent(_X)) = _Black;
+							_Color(_W) = _Color(_Xpar);
+							_Color(_Xpar) = _Black;
 							_Color(_Left(_W)) = _Black;
-							_Rrotate(_Parent(_X));
+							_Rrotate(_Xpar);
 							break;
 						}
 					}
-				_Color(_X) = _Black;
+				if (_X != _Nil())
+					_Color(_X) = _Black;
 			}
 			_Destval(&_Value(_Y));
 			_Freenode(_Y);
@@ -772,7 +1193,7 @@ namespace st6
 			else
 			{
 				_Erase(_Root());
-				_Root() = _Nil, _Size = 0;
+				_Root() = _Nil(), _Size = 0;
 				_Lmost() = _Head, _Rmost() = _Head;
 				return (begin());
 			}
@@ -832,13 +1253,21 @@ namespace st6
 		friend void swap(_Myt& _X, _Myt& _Y) { _X.swap(_Y); }
 
 	  protected:
-		static _Nodeptr _Nil;
-		static size_t _Nilrefs;
+		// The sentinel is a constant-initialized static which is only ever read, so trees may be built and torn down
+		// on any thread. Only the link and color fields of a _Node are accessed through it.
+		struct _Nilnode
+		{
+			_Nodeptr _Left, _Parent, _Right;
+			alignas(_Ty) unsigned char _Value[sizeof(_Ty)];
+			_Redbl _Color;
+		};
+		static _Nilnode _Nilstorage;
+		static _Nodeptr _Nil() { return (reinterpret_cast<_Nodeptr>(&_Nilstorage)); }
 		void _Copy(const _Myt& _X)
 		{
 			_Root() = _Copy(_X._Root(), _Head);
 			_Size = _X.size();
-			if (_Root() != _Nil)
+			if (_Root() != _Nil())
 			{
 				_Lmost() = _Min(_Root());
 				_Rmost() = _Max(_Root());
@@ -846,10 +1275,45 @@ namespace st6
 			else
 				_Lmost() = _Head, _Rmost() = _Head;
 		}
+		bool _Sorted(const value_type* _F, const value_type* _L) const
+		{
+			if (_F != _L)
+				for (const value_type* _N = _F; ++_N != _L; _F = _N)
+					if (!key_compare(_Kfn()(*_F), _Kfn()(*_N)))
+						return (false);
+			return (true);
+		}
+		// Builds a balanced tree from a strictly ascending range in linear time. Every level is full except possibly
+		// the deepest one, whose nodes are colored red, so all paths contain the same number of black nodes.
+		void _Build(const value_type* _F, const value_type* _L)
+		{
+			size_type _N = _L - _F;
+			size_type _Depth = 0;
+			while (((size_type)2 << _Depth) - 1 <= _N)
+				++_Depth;
+			_Root() = _Build(_F, _N, _Head, 0, _Depth);
+			_Size = _N;
+			if (_Root() != _Nil())
+			{
+				_Lmost() = _Min(_Root());
+				_Rmost() = _Max(_Root());
+			}
+		}
+		_Nodeptr _Build(const value_type* _F, size_type _N, _Nodeptr _P, size_type _Depth, size_type _Reddepth)
+		{
+			if (_N == 0)
+				return (_Nil());
+			size_type _M = (_N - 1) / 2;
+			_Nodeptr _X = _Buynode(_P, _Depth == _Reddepth ? _Red : _Black);
+			_Left(_X) = _Build(_F, _M, _X, _Depth + 1, _Reddepth);
+			_Consval(&_Value(_X), _F[_M]);
+			_Right(_X) = _Build(_F + _M + 1, _N - _M - 1, _X, _Depth + 1, _Reddepth);
+			return (_X);
+		}
 		_Nodeptr _Copy(_Nodeptr _X, _Nodeptr _P)
 		{
 			_Nodeptr _R = _X;
-			for (; _X != _Nil; _X = _Left(_X))
+			for (; _X != _Nil(); _X = _Left(_X))
 			{
 				_Nodeptr _Y = _Buynode(_P, _Color(_X));
 				if (_R == _X)
@@ -859,12 +1323,12 @@ namespace st6
 				_Left(_P) = _Y;
 				_P = _Y;
 			}
-			_Left(_P) = _Nil;
+			_Left(_P) = _Nil();
 			return (_R);
 		}
 		void _Erase(_Nodeptr _X)
 		{
-			for (_Nodeptr _Y = _X; _Y != _Nil; _X = _Y)
+			for (_Nodeptr _Y = _X; _Y != _Nil(); _X = _Y)
 			{
 				_Erase(_Right(_Y));
 				_Y = _Left(_Y);
@@ -874,22 +1338,16 @@ namespace st6
 		}
 		void _Init()
 		{
-			if (_Nil == 0)
-			{
-				_Nil = _Buynode(0, _Black);
-				_Left(_Nil) = 0, _Right(_Nil) = 0;
-			}
-			++_Nilrefs;
-			_Head = _Buynode(_Nil, _Red), _Size = 0;
+			_Head = _Buynode(_Nil(), _Red), _Size = 0;
 			_Lmost() = _Head, _Rmost() = _Head;
 		}
 		iterator _Insert(_Nodeptr _X, _Nodeptr _Y, const _Ty& _V)
 		{
 			_Nodeptr _Z = _Buynode(_Y, _Red);
-			_Left(_Z) = _Nil, _Right(_Z) = _Nil;
+			_Left(_Z) = _Nil(), _Right(_Z) = _Nil();
 			_Consval(&_Value(_Z), _V);
 			++_Size;
-			if (_Y == _Head || _X != _Nil || key_compare(_Kfn()(_V), _Key(_Y)))
+			if (_Y == _Head || _X != _Nil() || key_compare(_Kfn()(_V), _Key(_Y)))
 			{
 				_Left(_Y) = _Z;
 				if (_Y == _Head)
@@ -958,20 +1416,35 @@ namespace st6
 		{
 			_Nodeptr _X = _Root();
 			_Nodeptr _Y = _Head;
-			while (_X != _Nil)
+			while (_X != _Nil())
 				if (key_compare(_Key(_X), _Kv))
 					_X = _Right(_X);
 				else
 					_Y = _X, _X = _Left(_X);
 			return (_Y);
 		}
+		// Returns the black height of the subtree at _X, or 0 if it breaks an invariant.
+		size_type _Verify(_Nodeptr _X) const
+		{
+			if (_X == _Nil())
+				return (1);
+			_Nodeptr _L = _Left(_X), _R = _Right(_X);
+			if ((_L != _Nil() && _Parent(_L) != _X) || (_R != _Nil() && _Parent(_R) != _X))
+				return (0);
+			if (_Color(_X) == _Red && (_Color(_L) == _Red || _Color(_R) == _Red))
+				return (0);
+			size_type _H = _Verify(_L);
+			if (_H == 0 || _H != _Verify(_R))
+				return (0);
+			return (_Color(_X) == _Black ? _H + 1 : _H);
+		}
 		_Nodeptr& _Lmost() { return (_Left(_Head)); }
 		_Nodeptr& _Lmost() const { return (_Left(_Head)); }
 		void _Lrotate(_Nodeptr _X)
 		{
 			_Nodeptr _Y = _Right(_X);
 			_Right(_X) = _Left(_Y);
-			if (_Left(_Y) != _Nil)
+			if (_Left(_Y) != _Nil())
 				_Parent(_Left(_Y)) = _X;
 			_Parent(_Y) = _Parent(_X);
 			if (_X == _Root())
@@ -985,13 +1458,13 @@ namespace st6
 		}
 		static _Nodeptr _Max(_Nodeptr _P)
 		{
-			while (_Right(_P) != _Nil)
+			while (_Right(_P) != _Nil())
 				_P = _Right(_P);
 			return (_P);
 		}
 		static _Nodeptr _Min(_Nodeptr _P)
 		{
-			while (_Left(_P) != _Nil)
+			while (_Left(_P) != _Nil())
 				_P = _Left(_P);
 			return (_P);
 		}
@@ -1003,7 +1476,7 @@ namespace st6
 		{
 			_Nodeptr _Y = _Left(_X);
 			_Left(_X) = _Right(_Y);
-			if (_Right(_Y) != _Nil)
+			if (_Right(_Y) != _Nil())
 				_Parent(_Right(_Y)) = _X;
 			_Parent(_Y) = _Parent(_X);
 			if (_X == _Root())
@@ -1019,7 +1492,7 @@ namespace st6
 		{
 			_Nodeptr _X = _Root();
 			_Nodeptr _Y = _Head;
-			while (_X != _Nil)
+			while (_X != _Nil())
 				if (key_compare(_Kv, _Key(_X)))
 					_Y = _X, _X = _Left(_X);
 				else
@@ -1034,8 +1507,8 @@ namespace st6
 			return (_S);
 		}
 		void _Consval(_Tptr _P, const _Ty& _V) { _Construct(&*_P, _V); }
-		void _Destval(_Tptr _P) { _Destroy(&*_P); }
-		void _Freenode(_Nodeptr _S) { allocator.deallocate(_S, 1); }
+		void _Destval(_Tptr _P) { st6::_Destroy(&*_P); }
+		void _Freenode(_Nodeptr _S) { allocator._Chardealloc(_S, 1 * sizeof(_Node)); }
 		_A allocator;
 		_Pr key_compare;
 		_Nodeptr _Head;
@@ -1043,9 +1516,7 @@ namespace st6
 		size_type _Size;
 	};
 	template<class _K, class _Ty, class _Kfn, class _Pr, class _A>
-	typename _Tree<_K, _Ty, _Kfn, _Pr, _A>::_Nodeptr _Tree<_K, _Ty, _Kfn, _Pr, _A>::_Nil = 0;
-	template<class _K, class _Ty, class _Kfn, class _Pr, class _A>
-	size_t _Tree<_K, _Ty, _Kfn, _Pr, _A>::_Nilrefs = 0;
+	typename _Tree<_K, _Ty, _Kfn, _Pr, _A>::_Nilnode _Tree<_K, _Ty, _Kfn, _Pr, _A>::_Nilstorage = {0, 0, 0, {}, _Tree<_K, _Ty, _Kfn, _Pr, _A>::_Black};
 	template<class _K, class _Ty, class _Kfn, class _Pr, class _A>
 	inline bool operator==(const _Tree<_K, _Ty, _Kfn, _Pr, _A>& _X, const _Tree<_K, _Ty, _Kfn, _Pr, _A>& _Y)
 	{
@@ -1115,11 +1586,8 @@ namespace st6
 		typedef std::pair<const_iterator, const_iterator> _Paircc;
 		explicit map(const _Pr& _Pred = _Pr(), const _A& _Al = _A()) : _Tr(_Pred, false, _Al) {}
 		typedef const value_type* _It;
-		map(_It _F, _It _L, const _Pr& _Pred = _Pr(), const _A& _Al = _A()) : _Tr(_Pred, false, _Al)
-		{
-			for (; _F != _L; ++_F)
-				_Tr.insert(*_F);
-		}
+		map(_It _F, _It _L, const _Pr& _Pred = _Pr(), const _A& _Al = _A()) : _Tr(_Pred, false, _Al) { _Tr.insert(_F, _L); }
+		map(const _Myt& _X) : _Tr(_X._Tr) {}
 		_Myt& operator=(const _Myt& _X)
 		{
 			_Tr = _X._Tr;
@@ -1132,6 +1600,7 @@ namespace st6
 		size_type size() const { return (_Tr.size()); }
 		size_type max_size() const { return (_Tr.max_size()); }
 		bool empty() const { return (_Tr.empty()); }
+		bool _Verify() const { return (_Tr._Verify()); }
 		_A get_allocator() const { return (_Tr.get_allocator()); }
 		_Tref operator[](const key_type& _Kv)
 		{
@@ -1144,11 +1613,7 @@ namespace st6
 			return (_Pairib(_Ans.first, _Ans.second));
 		}
 		iterator insert(iterator _P, const value_type& _X) { return (_Tr.insert((typename _Imp::iterator&)_P, _X)); }
-		void insert(_It _F, _It _L)
-		{
-			for (; _F != _L; ++_F)
-				_Tr.insert(*_F);
-		}
+		void insert(_It _F, _It _L) { _Tr.insert(_F, _L); }
 		iterator erase(iterator _P) { return (_Tr.erase((typename _Imp::iterator&)_P)); }
 		iterator erase(iterator _F, iterator _L) { return (_Tr.erase((typename _Imp::iterator&)_F, (typename _Imp::iterator&)_L)); }
 		size_type erase(const _K& _Kv) { return (_Tr.erase(_Kv)); }
@@ -1168,7 +1633,7 @@ namespace st6
 		_Paircc equal_range(const _K& _Kv) const { return (_Tr.equal_range(_Kv)); }
 
 	  protected:
-		typename _Imp _Tr;
+		_Imp _Tr;
 	};
 	// map TEMPLATE OPERATORS
 	template<class _K, class _Ty, class _Pr, class _A>
@@ -1242,6 +1707,11 @@ namespace st6
 		class const_iterator
 		{
 		  public:
+			typedef std::bidirectional_iterator_tag iterator_category;
+			typedef _Ty value_type;
+			typedef typename _A::difference_type difference_type;
+			typedef _Ctptr pointer;
+			typedef const_reference reference;
 			const_iterator() {}
 			const_iterator(_Nodeptr _P) : _Ptr(_P) {}
 			const_iterator(const iterator& _X) : _Ptr(_X._Ptr) {}
@@ -1281,6 +1751,8 @@ namespace st6
 		class iterator : public const_iterator
 		{
 		  public:
+			typedef _Tptr pointer;
+			typedef typename _A::reference reference;
 			iterator() {}
 			iterator(_Nodeptr _P) : const_iterator(_P) {}
 			reference operator*() const { return (_Acc::_Value(this->_Ptr)); }
@@ -1352,6 +1824,21 @@ namespace st6
 		size_type size() const { return (_Size); }
 		size_type max_size() const { return (allocator.max_size()); }
 		bool empty() const { return (size() == 0); }
+		// Checks that the node ring is consistently linked in both directions and holds size() elements.
+		bool _Verify() const
+		{
+			size_type _N = 0;
+			for (_Nodeptr _P = _Head;; _P = _Acc::_Next(_P))
+			{
+				_Nodeptr _Nx = _Acc::_Next(_P);
+				if (_Nx == 0 || _Acc::_Prev(_Nx) != _P)
+					return (false);
+				if (_Nx == _Head)
+					return (_N == _Size);
+				if (++_N > _Size)
+					return (false);
+			}
+		}
 		_A get_allocator() const { return (allocator); }
 		reference front() { return (*begin()); }
 		const_reference front() const { return (*begin()); }
@@ -1474,22 +1961,26 @@ namespace st6
 		{
 			iterator _F = begin(), _L = end();
 			if (_F != _L)
+			{
 				for (iterator _M = _F; ++_M != _L; _M = _F)
 					if (*_F == *_M)
 						erase(_M);
 					else
 						_F = _M;
+			}
 		}
 		typedef std::not_equal_to<_Ty> _Pr2;
 		void unique(_Pr2 _Pr)
 		{
 			iterator _F = begin(), _L = end();
 			if (_F != _L)
+			{
 				for (iterator _M = _F; ++_M != _L; _M = _F)
 					if (_Pr(*_F, *_M))
 						erase(_M);
 					else
 						_F = _M;
+			}
 		}
 		void merge(_Myt& _X)
 		{
@@ -1613,7 +2104,7 @@ namespace st6
 			_Acc::_Prev(_S) = _Parg != 0 ? _Parg : _S;
 			return (_S);
 		}
-		void _Freenode(_Nodeptr _S) { allocator.deallocate(_S, 1); }
+		void _Freenode(_Nodeptr _S) { allocator._Chardealloc(_S, 1 * sizeof(_Node)); }
 		void _Splice(iterator _P, _Myt& _X, iterator _F, iterator _L)
 		{
 			if (allocator == _X.allocator)
@@ -1725,6 +2216,64 @@ namespace st6
 	typedef fpos<mbstate_t> streampos;
 	typedef streampos wstreampos;
 
+	// ASCII case folding for ci_hash and ci_equal. Characters outside 'A'-'Z' compare as they are.
+	template<class _E>
+	inline _E _Ci_fold(_E _C)
+	{
+		return (_C >= 'A' && _C <= 'Z' ? (_E)(_C + ('a' - 'A')) : _C);
+	}
+
+#ifdef ST6_SSE2
+	// Folds 16 bytes of 8-bit (_W == 1) or 16-bit (_W == 2) characters.
+	template<size_t _W>
+	inline __m128i _Ci_foldv(__m128i _X)
+	{
+		if constexpr (_W == 1)
+		{
+			__m128i _Up = _mm_cmpeq_epi8(_mm_subs_epu8(_mm_sub_epi8(_X, _mm_set1_epi8('A')), _mm_set1_epi8(25)), _mm_setzero_si128());
+			return (_mm_or_si128(_X, _mm_and_si128(_Up, _mm_set1_epi8(0x20))));
+		}
+		else
+		{
+			__m128i _Up = _mm_cmpeq_epi16(_mm_subs_epu16(_mm_sub_epi16(_X, _mm_set1_epi16('A')), _mm_set1_epi16(25)), _mm_setzero_si128());
+			return (_mm_or_si128(_X, _mm_and_si128(_Up, _mm_set1_epi16(0x20))));
+		}
+	}
+#endif
+
+	// Length of the prefix of whole 16-byte blocks in which _U and _V are equal, ASCII case folded if _Fold is set.
+	// Callers order the remainder with their scalar loop; without SSE2 or for other character types this is 0.
+	template<bool _Fold, class _E>
+	inline size_t _Equal_prefix(const _E* _U, const _E* _V, size_t _N)
+	{
+		size_t _I = 0;
+#ifdef ST6_SSE2
+		if constexpr (std::is_integral_v<_E> && (sizeof(_E) == 1 || sizeof(_E) == 2))
+			for (; _I + 16 / sizeof(_E) <= _N; _I += 16 / sizeof(_E))
+			{
+				__m128i _X = _mm_loadu_si128((const __m128i*)(_U + _I));
+				__m128i _Y = _mm_loadu_si128((const __m128i*)(_V + _I));
+				if constexpr (_Fold)
+					_X = _Ci_foldv<sizeof(_E)>(_X), _Y = _Ci_foldv<sizeof(_E)>(_Y);
+				if (_mm_movemask_epi8(_mm_cmpeq_epi8(_X, _Y)) != 0xFFFF)
+					break;
+			}
+#endif
+		return (_I);
+	}
+
+	template<class _E>
+	int _Ci_compare(const _E* _U, const _E* _V, size_t _N)
+	{
+		for (size_t _I = _Equal_prefix<true>(_U, _V, _N); _I < _N; ++_I)
+		{
+			_E _X = _Ci_fold(_U[_I]), _Y = _Ci_fold(_V[_I]);
+			if (_X != _Y)
+				return (_X < _Y ? -1 : +1);
+		}
+		return (0);
+	}
+
 	template<class _E>
 	struct char_traits
 	{
@@ -1738,7 +2287,8 @@ namespace st6
 		static bool __cdecl lt(const _E& _X, const _E& _Y) { return (_X < _Y); }
 		static int __cdecl compare(const _E* _U, const _E* _V, size_t _N)
 		{
-			for (size_t _I = 0; _I < _N; ++_I, ++_U, ++_V)
+			size_t _I = _Equal_prefix<false>(_U, _V, _N);
+			for (_U += _I, _V += _I; _I < _N; ++_I, ++_U, ++_V)
 				if (!eq(*_U, *_V))
 					return (lt(*_U, *_V) ? -1 : +1);
 			return (0);
@@ -2197,11 +2747,13 @@ namespace st6
 			if (_N == 0)
 				return (_P < _Len ? _P : _Len);
 			if (_N <= _Len)
+			{
 				for (const _E* _U = _Ptr + +(_P < _Len - _N ? _P : _Len - _N);; --_U)
 					if (_Tr::eq(*_U, *_S) && _Tr::compare(_U, _S, _N) == 0)
 						return (_U - _Ptr);
 					else if (_U == _Ptr)
 						break;
+			}
 			return (npos);
 		}
 		size_type rfind(const _E* _S, size_type _P = npos) const { return (rfind(_S, _P, _Tr::length(_S))); }
@@ -2224,11 +2776,13 @@ namespace st6
 		size_type find_last_of(const _E* _S, size_type _P, size_type _N) const
 		{
 			if (0 < _N && 0 < _Len)
+			{
 				for (const _E* _U = _Ptr + (_P < _Len ? _P : _Len - 1);; --_U)
 					if (_Tr::find(_S, _N, *_U) != 0)
 						return (_U - _Ptr);
 					else if (_U == _Ptr)
 						break;
+			}
 			return (npos);
 		}
 		size_type find_last_of(const _E* _S, size_type _P = npos) const { return (find_last_of(_S, _P, _Tr::length(_S))); }
@@ -2251,11 +2805,13 @@ namespace st6
 		size_type find_last_not_of(const _E* _S, size_type _P, size_type _N) const
 		{
 			if (0 < _Len)
+			{
 				for (const _E* _U = _Ptr + (_P < _Len ? _P : _Len - 1);; --_U)
 					if (_Tr::find(_S, _N, *_U) == 0)
 						return (_U - _Ptr);
 					else if (_U == _Ptr)
 						break;
+			}
 			return (npos);
 		}
 		size_type find_last_not_of(const _E* _S, size_type _P = npos) const { return (find_last_not_of(_S, _P, _Tr::length(_S))); }
@@ -2328,6 +2884,7 @@ namespace st6
 			if (max_size() < _N)
 				_Xlen();
 			if (_Ptr != 0 && _Refcnt(_Ptr) != 0 && _Refcnt(_Ptr) != _FROZEN)
+			{
 				if (_N == 0)
 				{
 					--_Refcnt(_Ptr), _Tidy();
@@ -2338,6 +2895,7 @@ namespace st6
 					_Copy(_N);
 					return (true);
 				}
+			}
 			if (_N == 0)
 			{
 				if (_Trim)
@@ -2520,4 +3078,97 @@ namespace st6
 {
 	typedef basic_string<char, ci_char_traits, allocator<char>> string;
 	typedef basic_string<unsigned short, ci_wchar_traits, allocator<unsigned short>> wstring;
+
+	// FNV-1a over the ASCII case folded characters, consistent with ci_equal.
+	template<class _E>
+	size_t _Ci_hash(const _E* _U, size_t _N)
+	{
+		size_t _H = sizeof(size_t) == 8 ? (size_t)14695981039346656037ULL : (size_t)2166136261U;
+		for (; 0 < _N; --_N, ++_U)
+			_H = (_H ^ (size_t)(std::make_unsigned_t<_E>)_Ci_fold(*_U)) * (sizeof(size_t) == 8 ? (size_t)1099511628211ULL : (size_t)16777619U);
+		return (_H);
+	}
+
+	// Opt-in ASCII case insensitive hash and equality for keying hash tables by account or character name, e.g.
+	// std::unordered_map<st6::wstring, T, st6::ci_hash, st6::ci_equal>. st6::string and st6::wstring themselves
+	// still compare exactly through char_traits.
+	struct ci_hash
+	{
+		template<class _E, class _Tr, class _A>
+		size_t operator()(const basic_string<_E, _Tr, _A>& _S) const
+		{
+			return (_Ci_hash(_S.c_str(), _S.size()));
+		}
+	};
+
+	struct ci_equal
+	{
+		template<class _E, class _Tr, class _A>
+		bool operator()(const basic_string<_E, _Tr, _A>& _X, const basic_string<_E, _Tr, _A>& _Y) const
+		{
+			return (_X.size() == _Y.size() && _Ci_compare(_X.c_str(), _Y.c_str(), _X.size()) == 0);
+		}
+	};
+} // namespace st6
+
+namespace st6
+{
+	// Non-owning views over st6 containers, for use with the standard library without copying.
+	// Views of a non-const string freeze it first, so it owns an unshared buffer and the view stays valid until that
+	// string is modified or destroyed. A view of a const string may point into a buffer shared with other copies: any
+	// non-const access to the source, even begin() or operator[], moves it to a new buffer and invalidates the view.
+#ifdef __cpp_lib_span
+	template<class _Ty, class _A>
+	std::span<_Ty> as_span(vector<_Ty, _A>& _V)
+	{
+		return (std::span<_Ty>(_V.begin(), _V.size()));
+	}
+
+	template<class _Ty, class _A>
+	std::span<const _Ty> as_span(const vector<_Ty, _A>& _V)
+	{
+		return (std::span<const _Ty>(_V.begin(), _V.size()));
+	}
+#endif
+
+	template<class _Tr, class _A>
+	std::string_view as_string_view(const basic_string<char, _Tr, _A>& _S)
+	{
+		return (std::string_view(_S.c_str(), _S.size()));
+	}
+
+	template<class _Tr, class _A>
+	std::string_view as_string_view(basic_string<char, _Tr, _A>& _S)
+	{
+		_S.begin();
+		return (std::string_view(_S.c_str(), _S.size()));
+	}
+
+	template<class _Tr, class _A>
+	std::u16string_view as_u16string_view(const basic_string<unsigned short, _Tr, _A>& _S)
+	{
+		return (std::u16string_view(reinterpret_cast<const char16_t*>(_S.c_str()), _S.size()));
+	}
+
+	template<class _Tr, class _A>
+	std::u16string_view as_u16string_view(basic_string<unsigned short, _Tr, _A>& _S)
+	{
+		_S.begin();
+		return (std::u16string_view(reinterpret_cast<const char16_t*>(_S.c_str()), _S.size()));
+	}
+
+	template<class _Tr, class _A>
+	std::wstring_view as_wstring_view(const basic_string<unsigned short, _Tr, _A>& _S)
+	{
+		static_assert(sizeof(wchar_t) == sizeof(typename _A::value_type), "st6::wstring can only be viewed as wchar_t where wchar_t is 16-bit");
+		return (std::wstring_view(reinterpret_cast<const wchar_t*>(_S.c_str()), _S.size()));
+	}
+
+	template<class _Tr, class _A>
+	std::wstring_view as_wstring_view(basic_string<unsigned short, _Tr, _A>& _S)
+	{
+		static_assert(sizeof(wchar_t) == sizeof(typename _A::value_type), "st6::wstring can only be viewed as wchar_t where wchar_t is 16-bit");
+		_S.begin();
+		return (std::wstring_view(reinterpret_cast<const wchar_t*>(_S.c_str()), _S.size()));
+	}
 } // namespace st6
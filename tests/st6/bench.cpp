@@ -0,0 +1,488 @@
+// Micro benchmarks of the st6 containers next to their std:: equivalents, reported as ns per operation.
+//
+// Usage: st6_bench [--quick] [name filter]
+
+#include "st6_gcc.h"
+
+#include <chrono>
+#include <cstring>
+#include <list>
+#include <map>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace
+{
+	int scale = 1;
+	const char* filter = "";
+	volatile size_t sink;
+
+	template<class F>
+	void Run(const char* name, size_t ops, F body)
+	{
+		if (std::strstr(name, filter) == nullptr)
+			return;
+		ops /= (size_t)scale;
+		if (ops == 0)
+			ops = 1;
+		body(ops); // warm up allocator and caches
+		double best = 1e300;
+		for (int rep = 0; rep < 3; ++rep)
+		{
+			auto t0 = std::chrono::steady_clock::now();
+			body(ops);
+			double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+			if (ns < best)
+				best = ns;
+		}
+		std::printf("%-44s %12zu ops %10.2f ns/op\n", name, ops, best / (double)ops);
+	}
+
+	std::vector<int> Shuffled(size_t n)
+	{
+		std::vector<int> keys(n);
+		for (size_t i = 0; i < n; ++i)
+			keys[i] = (int)i;
+		std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+		return keys;
+	}
+
+	template<class T>
+	T Make(int i)
+	{
+		return T(i);
+	}
+
+	template<>
+	std::string Make<std::string>(int i)
+	{
+		return std::string(24, (char)('a' + i % 26));
+	}
+
+	// Counts the copies and moves vector growth makes of its elements. With a move constructor which may throw,
+	// relocation falls back to copying, which is what st6::vector did for every type before it learned to move.
+	template<bool _Nothrow>
+	struct Counted
+	{
+		static size_t copies, moves;
+		int v;
+		Counted(int x = 0) : v(x) {}
+		Counted(const Counted& o) : v(o.v) { ++copies; }
+		Counted(Counted&& o) noexcept(_Nothrow) : v(o.v) { ++moves; }
+		Counted& operator=(const Counted& o)
+		{
+			v = o.v, ++copies;
+			return *this;
+		}
+		Counted& operator=(Counted&& o) noexcept(_Nothrow)
+		{
+			v = o.v, ++moves;
+			return *this;
+		}
+	};
+	template<bool _Nothrow>
+	size_t Counted<_Nothrow>::copies = 0;
+	template<bool _Nothrow>
+	size_t Counted<_Nothrow>::moves = 0;
+
+	// Appends n elements with add(v, i), which must construct them in place, and reports the element copies and
+	// moves made by the reallocations. C is the Counted type whose counters to read.
+	template<class V, class C, class F>
+	void Growth(const char* name, size_t n, F add)
+	{
+		if (std::strstr(name, filter) == nullptr)
+			return;
+		V v;
+		size_t growths = 0;
+		C::copies = 0, C::moves = 0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			growths += v.size() == v.capacity();
+			add(v, (int)i);
+		}
+		std::printf("%-44s %12zu ops %5zu growths %8.1f copies %8.1f moves per growth\n", name, n, growths,
+			(double)C::copies / (double)growths, (double)C::moves / (double)growths);
+	}
+
+	template<class V>
+	void VectorPush(size_t n)
+	{
+		V v;
+		for (size_t i = 0; i < n; ++i)
+			v.push_back(Make<typename V::value_type>((int)i));
+		sink = v.size();
+	}
+
+	template<class V>
+	void VectorPushNested(size_t n)
+	{
+		V v;
+		for (size_t i = 0; i < n; ++i)
+			v.emplace_back().push_back((int)i);
+		sink = v.size();
+	}
+
+	template<class V>
+	void VectorInsertFront(size_t n)
+	{
+		V v;
+		for (size_t i = 0; i < n; ++i)
+			v.insert(v.begin(), Make<typename V::value_type>((int)i));
+		sink = v.size();
+	}
+
+	template<class L>
+	void ListPushIterate(size_t n)
+	{
+		L l;
+		for (size_t i = 0; i < n; ++i)
+			l.push_back((int)i);
+		size_t sum = 0;
+		for (auto i = l.begin(); i != l.end(); ++i)
+			sum += (size_t)*i;
+		sink = sum;
+	}
+
+	// A small container filled and cleared over and over, like a per-tick DamageList or EquipDescList: n insert+erase
+	// cycles in batches of 16, so the node pool stays in its steady state
+	template<class L>
+	void ListChurn(size_t n)
+	{
+		L l;
+		size_t total = 0;
+		for (size_t i = 0; i < n; i += 16)
+		{
+			for (int k = 0; k < 16; ++k)
+				l.push_back(k);
+			total += l.size();
+			l.clear();
+		}
+		sink = total;
+	}
+
+	template<class M>
+	void MapChurn(size_t n)
+	{
+		M m;
+		size_t total = 0;
+		for (size_t i = 0; i < n; i += 16)
+		{
+			for (int k = 0; k < 16; ++k)
+				m.insert(typename M::value_type((k * 7) & 15, k));
+			total += m.size();
+			m.clear();
+		}
+		sink = total;
+	}
+
+	// Short-lived names and id lists built and dropped over and over; n strings or vectors in batches of 8
+	template<class S>
+	void StringChurn(size_t n)
+	{
+		static const char* const names[8] = {"Trent", "Juni", "King", "Orillion", "Tobias Edison Ward", "Casper",
+			"a name of some forty characters in length", "Li_Police_Patrol_Cruiser_Lieutenant_Commander"};
+		size_t total = 0;
+		for (size_t i = 0; i < n; i += 8)
+		{
+			S batch[8];
+			for (int k = 0; k < 8; ++k)
+				batch[k] = names[k];
+			for (int k = 0; k < 8; ++k)
+				total += batch[k].size();
+		}
+		sink = total;
+	}
+
+	template<class V>
+	void SmallVectorChurn(size_t n)
+	{
+		size_t total = 0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			V v;
+			for (int k = 0; k < 4; ++k)
+				v.push_back(k);
+			total += v.size();
+		}
+		sink = total;
+	}
+
+	// A per-tick list like the XCollision groups: built, walked and dropped, then the tick ends. Batches of 64
+	template<class L, bool _Arena>
+	void TickList(size_t n)
+	{
+		size_t total = 0;
+		for (size_t i = 0; i < n; i += 64)
+		{
+			{
+				L l;
+				for (int k = 0; k < 64; ++k)
+					l.push_back(k);
+				for (auto it = l.begin(); it != l.end(); ++it)
+					total += (size_t)*it;
+			}
+			if (_Arena)
+				st6::tick_arena::get().reset();
+		}
+		sink = total;
+	}
+
+	template<class M>
+	void MapInsertRandom(size_t n)
+	{
+		static std::vector<int> keys;
+		if (keys.size() != n)
+			keys = Shuffled(n);
+		M m;
+		for (size_t i = 0; i < n; ++i)
+			m.insert(typename M::value_type(keys[i], (int)i));
+		sink = m.size();
+	}
+
+	template<class M>
+	void MapInsertAscendingHinted(size_t n)
+	{
+		M m;
+		auto hint = m.end();
+		for (size_t i = 0; i < n; ++i)
+			hint = m.insert(hint, typename M::value_type((int)i, (int)i));
+		sink = m.size();
+	}
+
+	template<class M>
+	void MapInsertLoopSorted(size_t n)
+	{
+		M m;
+		for (size_t i = 0; i < n; ++i)
+			m.insert(typename M::value_type((int)i, (int)i));
+		sink = m.size();
+	}
+
+	template<class M>
+	void MapBuildSorted(size_t n)
+	{
+		static std::vector<typename M::value_type> src;
+		if (src.size() != n)
+		{
+			src.clear();
+			for (size_t i = 0; i < n; ++i)
+				src.push_back(typename M::value_type((int)i, (int)i));
+		}
+		M m(&*src.begin(), &*src.begin() + src.size());
+		sink = m.size();
+	}
+
+	template<class M>
+	void MapFindErase(size_t n)
+	{
+		static std::vector<int> keys;
+		if (keys.size() != n)
+			keys = Shuffled(n);
+		M m;
+		for (size_t i = 0; i < n; ++i)
+			m.insert(typename M::value_type((int)i, (int)i));
+		size_t found = 0;
+		for (size_t i = 0; i < n; ++i)
+			found += m.find(keys[i]) != m.end();
+		for (size_t i = 0; i < n; ++i)
+			m.erase(keys[i]);
+		sink = found + m.size();
+	}
+
+	template<class S>
+	void StringAppend(size_t n)
+	{
+		S s;
+		for (size_t i = 0; i < n; ++i)
+			s.append("name", 4);
+		sink = s.size();
+	}
+
+	template<class S>
+	void StringCopy(size_t n)
+	{
+		S s("a character name long enough to leave any small string buffer");
+		size_t total = 0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			S c(s);
+			total += c.size();
+		}
+		sink = total;
+	}
+
+	// What handing a character name or an id list to std code costs: a copy into a std container, or a view
+	const st6::wstring& Name()
+	{
+		static const st6::wstring name(reinterpret_cast<const unsigned short*>(u"Trent.Ageira.Captain.Of.The.Liberty"));
+		return name;
+	}
+
+	void NameToU16string(size_t n)
+	{
+		size_t total = 0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			std::u16string copy(reinterpret_cast<const char16_t*>(Name().c_str()), Name().size());
+			total += (size_t)std::count(copy.begin(), copy.end(), u'e');
+		}
+		sink = total;
+	}
+
+	void NameAsU16stringView(size_t n)
+	{
+		size_t total = 0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			std::u16string_view view = st6::as_u16string_view(Name());
+			total += (size_t)std::count(view.begin(), view.end(), u'e');
+		}
+		sink = total;
+	}
+
+	const st6::vector<unsigned int>& Ids()
+	{
+		static st6::vector<unsigned int> ids(64, 0x9876u);
+		return ids;
+	}
+
+	void IdsToVector(size_t n)
+	{
+		size_t total = 0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			std::vector<unsigned int> copy(Ids().begin(), Ids().end());
+			total += (size_t)std::count(copy.begin(), copy.end(), 0x9876u);
+		}
+		sink = total;
+	}
+
+	void IdsAsSpan(size_t n)
+	{
+		size_t total = 0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			std::span<const unsigned int> view = st6::as_span(Ids());
+			total += (size_t)std::count(view.begin(), view.end(), 0x9876u);
+		}
+		sink = total;
+	}
+
+	void CompareEqualPrefix(size_t n)
+	{
+		std::string a(40, 'a'), b(40, 'a');
+		b[39] = 'b';
+		int total = 0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			total += ci_char_traits::compare(a.data(), b.data(), a.size());
+			asm volatile("" : : "r"(a.data()) : "memory");
+		}
+		sink = (size_t)total;
+	}
+
+	void CompareEqualPrefixScalar(size_t n)
+	{
+		std::string a(40, 'a'), b(40, 'a');
+		b[39] = 'b';
+		int total = 0;
+		for (size_t i = 0; i < n; ++i)
+		{
+			for (size_t k = 0; k < a.size(); ++k)
+				if (a[k] != b[k])
+				{
+					total += a[k] < b[k] ? -1 : 1;
+					break;
+				}
+			asm volatile("" : : "r"(a.data()) : "memory");
+		}
+		sink = (size_t)total;
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	int arg = 1;
+	if (arg < argc && std::strcmp(argv[arg], "--quick") == 0)
+		scale = 1000, ++arg;
+	if (arg < argc)
+		filter = argv[arg];
+
+	typedef st6::map<int, int> SMap;
+	typedef st6::map<int, int, std::less<int>, st6::node_allocator<int>> SPoolMap;
+	typedef std::map<int, int> RMap;
+
+	Run("vector<int>::push_back st6", 1000000, VectorPush<st6::vector<int>>);
+	Run("vector<int>::push_back std", 1000000, VectorPush<std::vector<int>>);
+	Run("vector<string>::push_back st6", 200000, VectorPush<st6::vector<std::string>>);
+	Run("vector<string>::push_back std", 200000, VectorPush<std::vector<std::string>>);
+	Run("vector<vector<int>>::push_back st6", 200000, VectorPushNested<st6::vector<st6::vector<int>>>);
+	Run("vector<vector<int>>::push_back std", 200000, VectorPushNested<std::vector<std::vector<int>>>);
+	Run("vector<int>::insert(begin) st6", 20000, VectorInsertFront<st6::vector<int>>);
+	Run("vector<int>::insert(begin) std", 20000, VectorInsertFront<std::vector<int>>);
+	Run("list<int> push_back+iterate st6", 1000000, ListPushIterate<st6::list<int>>);
+	Run("list<int> push_back+iterate st6 node_allocator", 1000000, ListPushIterate<st6::list<int, st6::node_allocator<int>>>);
+	Run("list<int> push_back+iterate std", 1000000, ListPushIterate<std::list<int>>);
+	Run("list<int> churn 16 st6", 1000000, ListChurn<st6::list<int>>);
+	Run("list<int> churn 16 st6 node_allocator", 1000000, ListChurn<st6::list<int, st6::node_allocator<int>>>);
+	Run("list<int> churn 16 std", 1000000, ListChurn<std::list<int>>);
+	Run("map churn 16 st6", 1000000, MapChurn<SMap>);
+	Run("map churn 16 st6 node_allocator", 1000000, MapChurn<SPoolMap>);
+	Run("map churn 16 std", 1000000, MapChurn<RMap>);
+	typedef st6::basic_string<char, st6::char_traits<char>, st6::pool_allocator<char>> PString;
+	Run("string churn 8 st6", 1000000, StringChurn<st6::string>);
+	Run("string churn 8 st6 pool_allocator", 1000000, StringChurn<PString>);
+	Run("string churn 8 std", 1000000, StringChurn<std::string>);
+	Run("vector<int> churn 4 st6", 1000000, SmallVectorChurn<st6::vector<int>>);
+	Run("vector<int> churn 4 st6 pool_allocator", 1000000, SmallVectorChurn<st6::vector<int, st6::pool_allocator<int>>>);
+	Run("vector<int> churn 4 std", 1000000, SmallVectorChurn<std::vector<int>>);
+	Run("list<int> per tick 64 st6", 1000000, TickList<st6::list<int>, false>);
+	Run("list<int> per tick 64 st6 node_allocator", 1000000, TickList<st6::list<int, st6::node_allocator<int>>, false>);
+	Run("list<int> per tick 64 st6 arena_allocator", 1000000, TickList<st6::list<int, st6::arena_allocator<int>>, true>);
+	Run("list<int> per tick 64 std", 1000000, TickList<std::list<int>, false>);
+	Run("map insert random st6", 500000, MapInsertRandom<SMap>);
+	Run("map insert random st6 node_allocator", 500000, MapInsertRandom<SPoolMap>);
+	Run("map insert random std", 500000, MapInsertRandom<RMap>);
+	Run("map insert ascending hinted st6", 1000000, MapInsertAscendingHinted<SMap>);
+	Run("map insert ascending hinted std", 1000000, MapInsertAscendingHinted<RMap>);
+	for (size_t keys : {10000, 100000, 1000000})
+	{
+		// The same sorted keys: bulk build, the per-element insert loop it replaces, and hinted inserts
+		char name[64];
+		std::snprintf(name, sizeof(name), "map %zuk sorted build from range st6", keys / 1000);
+		Run(name, keys, MapBuildSorted<SMap>);
+		std::snprintf(name, sizeof(name), "map %zuk sorted insert loop st6", keys / 1000);
+		Run(name, keys, MapInsertLoopSorted<SMap>);
+		std::snprintf(name, sizeof(name), "map %zuk sorted insert hinted st6", keys / 1000);
+		Run(name, keys, MapInsertAscendingHinted<SMap>);
+		std::snprintf(name, sizeof(name), "map %zuk sorted build from range std", keys / 1000);
+		Run(name, keys, MapBuildSorted<RMap>);
+	}
+	Run("map find+erase st6", 500000, MapFindErase<SMap>);
+	Run("map find+erase std", 500000, MapFindErase<RMap>);
+	// st6::basic_string grows its buffer by a fixed step like VC6's, so a long run of appends is quadratic
+	Run("string append st6", 20000, StringAppend<st6::string>);
+	Run("string append std", 20000, StringAppend<std::string>);
+	Run("string copy (COW) st6", 1000000, StringCopy<st6::string>);
+	Run("string copy std", 1000000, StringCopy<std::string>);
+	Run("wstring name -> std::u16string + count", 1000000, NameToU16string);
+	Run("wstring name as_u16string_view + count", 1000000, NameAsU16stringView);
+	Run("vector<uint>(64) -> std::vector + count", 1000000, IdsToVector);
+	Run("vector<uint>(64) as_span + count", 1000000, IdsAsSpan);
+	Run("char_traits::compare 40 chars st6", 10000000, CompareEqualPrefix);
+	Run("char_traits::compare 40 chars scalar loop", 10000000, CompareEqualPrefixScalar);
+
+	typedef Counted<true> Movable;
+	typedef Counted<false> CopyOnGrowth;
+	auto element = [](auto& v, int i) { v.emplace_back(i); };
+	auto nested = [](auto& v, int i) { v.emplace_back().emplace_back(i); };
+	Growth<st6::vector<Movable>, Movable>("growth vector<T> st6", 100000, element);
+	Growth<std::vector<Movable>, Movable>("growth vector<T> std", 100000, element);
+	Growth<st6::vector<CopyOnGrowth>, CopyOnGrowth>("growth vector<T> throwing move st6", 100000, element);
+	Growth<std::vector<CopyOnGrowth>, CopyOnGrowth>("growth vector<T> throwing move std", 100000, element);
+	Growth<st6::vector<st6::vector<Movable>>, Movable>("growth vector<vector<T>> st6", 100000, nested);
+	Growth<std::vector<std::vector<Movable>>, Movable>("growth vector<vector<T>> std", 100000, nested);
+	return 0;
+}
@@ -0,0 +1,9 @@
+// st6.h must keep building as C++17 for plugins which are not on C++20 yet. Compiled, never run.
+
+#include "st6_gcc.h"
+
+template class st6::vector<int>;
+template class st6::list<int>;
+template class st6::map<int, int>;
+template class st6::basic_string<char, st6::char_traits<char>, st6::allocator<char>>;
+template class st6::basic_string<unsigned short, st6::char_traits<unsigned short>, st6::allocator<unsigned short>>;
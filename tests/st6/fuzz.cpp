@@ -0,0 +1,802 @@
+// Differential fuzz of the st6 containers against their std:: equivalents. Every step is mirrored on both sides and
+// compared, and trees and lists are checked with _Verify() after each operation.
+//
+// Usage: st6_fuzz [seed] [rounds]
+
+#include "st6_gcc.h"
+
+#include <cstdint>
+#include <list>
+#include <map>
+#include <random>
+#include <ranges>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define CHECK(x)                                                                    \
+	do                                                                              \
+	{                                                                               \
+		if (!(x))                                                                   \
+		{                                                                           \
+			std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #x); \
+			std::abort();                                                           \
+		}                                                                           \
+	} while (0)
+
+// Vector growth only moves elements which cannot throw while being moved; nested vectors must not be deep copied
+static_assert(std::is_nothrow_move_constructible<st6::vector<int>>::value);
+static_assert(std::is_nothrow_move_assignable<st6::vector<int>>::value);
+
+// list and map iterators must work with <algorithm> and std::ranges without adapting them
+static_assert(std::bidirectional_iterator<st6::list<int>::iterator>);
+static_assert(std::bidirectional_iterator<st6::list<int>::const_iterator>);
+static_assert(std::bidirectional_iterator<st6::map<int, int>::iterator>);
+static_assert(std::bidirectional_iterator<st6::map<int, int>::const_iterator>);
+static_assert(std::ranges::bidirectional_range<st6::list<int, st6::node_allocator<int>>>);
+static_assert(std::ranges::bidirectional_range<const st6::map<int, int>>);
+static_assert(std::ranges::contiguous_range<decltype(st6::as_span(std::declval<st6::vector<int>&>()))>);
+
+namespace
+{
+	typedef std::mt19937 Rng;
+
+	int Pick(Rng& rng, int n) { return (int)(rng() % (unsigned)n); }
+
+	// Owns heap memory and counts live instances, so vector relocation must run the move constructor and destroy
+	// exactly once. Not trivially relocatable.
+	struct Tracked
+	{
+		static int live;
+		int* p;
+		Tracked(int v = 0) : p(new int(v)) { ++live; }
+		Tracked(const Tracked& o) : p(new int(*o.p)) { ++live; }
+		Tracked(Tracked&& o) noexcept : p(o.p)
+		{
+			o.p = nullptr;
+			++live;
+		}
+		Tracked& operator=(const Tracked& o)
+		{
+			if (this != &o)
+			{
+				delete p;
+				p = new int(*o.p);
+			}
+			return *this;
+		}
+		Tracked& operator=(Tracked&& o) noexcept
+		{
+			std::swap(p, o.p);
+			return *this;
+		}
+		~Tracked()
+		{
+			delete p;
+			--live;
+		}
+		int value() const { return p ? *p : -1; }
+		bool operator==(const Tracked& o) const { return value() == o.value(); }
+	};
+	int Tracked::live = 0;
+
+	int Value(int v) { return v; }
+	int Value(const Tracked& v) { return v.value(); }
+
+	template<class S, class R>
+	void SameSequence(const S& s, const R& r)
+	{
+		CHECK(s.size() == r.size());
+		auto j = r.begin();
+		for (auto i = s.begin(); i != s.end(); ++i, ++j)
+			CHECK(Value(*i) == Value(*j));
+	}
+
+	template<class T>
+	void FuzzVector(Rng& rng, int steps)
+	{
+		st6::vector<T> s;
+		std::vector<T> r;
+		for (int step = 0; step < steps; ++step)
+		{
+			int v = Pick(rng, 1000);
+			size_t pos = r.empty() ? 0 : (size_t)Pick(rng, (int)r.size() + 1);
+			switch (Pick(rng, 15))
+			{
+				case 0:
+				{
+					T x(v);
+					s.push_back(x);
+					r.push_back(x);
+					break;
+				}
+				case 1:
+					s.push_back(T(v));
+					r.push_back(T(v));
+					break;
+				case 2:
+					s.emplace_back(v);
+					r.emplace_back(v);
+					break;
+				case 3:
+					if (!r.empty() && Pick(rng, 2))
+					{
+						// Inserting an element of the vector itself
+						size_t k = (size_t)Pick(rng, (int)r.size());
+						s.insert(s.begin() + pos, s[k]);
+						r.insert(r.begin() + pos, r[k]);
+					}
+					else
+					{
+						s.insert(s.begin() + pos, T(v));
+						r.insert(r.begin() + pos, T(v));
+					}
+					break;
+				case 4:
+				{
+					size_t n = (size_t)Pick(rng, 8);
+					if (!r.empty() && Pick(rng, 2))
+					{
+						size_t k = (size_t)Pick(rng, (int)r.size());
+						s.insert(s.begin() + pos, n, s[k]);
+						r.insert(r.begin() + pos, n, r[k]);
+					}
+					else
+					{
+						s.insert(s.begin() + pos, n, T(v));
+						r.insert(r.begin() + pos, n, T(v));
+					}
+					break;
+				}
+				case 5:
+				{
+					std::vector<T> src;
+					for (int n = Pick(rng, 8); n > 0; --n)
+						src.push_back(T(Pick(rng, 1000)));
+					s.insert(s.begin() + pos, src.data(), src.data() + src.size());
+					r.insert(r.begin() + pos, src.begin(), src.end());
+					break;
+				}
+				case 6:
+					if (pos < r.size())
+					{
+						s.erase(s.begin() + pos);
+						r.erase(r.begin() + pos);
+					}
+					break;
+				case 7:
+				{
+					size_t last = pos + (size_t)Pick(rng, 5);
+					if (last > r.size())
+						last = r.size();
+					s.erase(s.begin() + pos, s.begin() + last);
+					r.erase(r.begin() + pos, r.begin() + last);
+					break;
+				}
+				case 8:
+					if (!r.empty())
+					{
+						s.pop_back();
+						r.pop_back();
+					}
+					break;
+				case 9:
+					s.reserve((size_t)Pick(rng, 64));
+					CHECK(s.capacity() >= s.size());
+					break;
+				case 10:
+				{
+					size_t n = (size_t)Pick(rng, 40);
+					s.resize(n, T(v));
+					r.resize(n, T(v));
+					break;
+				}
+				case 11:
+				{
+					st6::vector<T> c(s);
+					SameSequence(c, r);
+					s = c;
+					break;
+				}
+				case 12:
+				{
+					st6::vector<T> m(std::move(s));
+					s = std::move(m);
+					break;
+				}
+				case 13:
+				{
+					size_t n = (size_t)Pick(rng, 10);
+					s.assign(n, T(v));
+					r.assign(n, T(v));
+					break;
+				}
+				case 14:
+					if (Pick(rng, 20) == 0)
+					{
+						s.clear();
+						r.clear();
+					}
+					break;
+			}
+			SameSequence(s, r);
+		}
+	}
+
+	template<class A>
+	void FuzzList(Rng& rng, int steps)
+	{
+		typedef st6::list<int, A> L;
+		L s;
+		std::list<int> r;
+		for (int step = 0; step < steps; ++step)
+		{
+			int v = Pick(rng, 50);
+			size_t pos = (size_t)Pick(rng, (int)r.size() + 1);
+			auto si = s.begin();
+			auto ri = r.begin();
+			for (size_t k = 0; k < pos; ++k)
+				++si, ++ri;
+			switch (Pick(rng, 11))
+			{
+				case 0:
+					s.push_back(v);
+					r.push_back(v);
+					break;
+				case 1:
+					s.push_front(v);
+					r.push_front(v);
+					break;
+				case 2:
+					s.insert(si, v);
+					r.insert(ri, v);
+					break;
+				case 3:
+				{
+					size_t n = (size_t)Pick(rng, 5);
+					s.insert(si, n, v);
+					r.insert(ri, n, v);
+					break;
+				}
+				case 4:
+					if (pos < r.size())
+					{
+						s.erase(si);
+						r.erase(ri);
+					}
+					break;
+				case 5:
+				{
+					auto sl = si;
+					auto rl = ri;
+					for (int n = Pick(rng, 4); n > 0 && rl != r.end(); --n)
+						++sl, ++rl;
+					s.erase(si, sl);
+					r.erase(ri, rl);
+					break;
+				}
+				case 6:
+					s.remove(v);
+					r.remove(v);
+					break;
+				case 7:
+					s.sort();
+					r.sort();
+					break;
+				case 8:
+					s.reverse();
+					r.reverse();
+					break;
+				case 9:
+					s.unique();
+					r.unique();
+					break;
+				case 10:
+				{
+					L so;
+					std::list<int> ro;
+					for (int n = Pick(rng, 5); n > 0; --n)
+					{
+						int x = Pick(rng, 50);
+						so.push_back(x);
+						ro.push_back(x);
+					}
+					s.splice(si, so);
+					r.splice(ri, ro);
+					CHECK(so.empty() && so._Verify());
+					break;
+				}
+			}
+			CHECK(s._Verify());
+			SameSequence(s, r);
+		}
+	}
+
+	template<class A>
+	void FuzzMap(Rng& rng, int steps, int keys)
+	{
+		typedef st6::map<int, int, std::less<int>, A> M;
+		typedef typename M::value_type V;
+		M s;
+		std::map<int, int> r;
+		auto same = [&]()
+		{
+			CHECK(s._Verify());
+			CHECK(s.size() == r.size());
+			auto j = r.begin();
+			for (auto i = s.begin(); i != s.end(); ++i, ++j)
+				CHECK(i->first == j->first && i->second == j->second);
+		};
+		typename M::iterator last = s.end();
+		for (int step = 0; step < steps; ++step)
+		{
+			int k = Pick(rng, keys);
+			int v = Pick(rng, 1000);
+			switch (Pick(rng, 13))
+			{
+				case 0:
+				{
+					auto a = s.insert(V(k, v));
+					auto b = r.insert({k, v});
+					CHECK(a.second == b.second && a.first->first == k && a.first->second == b.first->second);
+					last = a.first;
+					break;
+				}
+				case 1:
+				case 2:
+				{
+					// Hinted insert: end(), the previous result (ascending inserts), begin() or an arbitrary element
+					typename M::iterator hint = s.end();
+					int h = Pick(rng, 4);
+					if (h == 1)
+						hint = last;
+					else if (h == 2)
+						hint = s.begin();
+					else if (h == 3 && !s.empty())
+					{
+						hint = s.begin();
+						for (int n = Pick(rng, (int)s.size()); n > 0; --n)
+							++hint;
+					}
+					auto a = s.insert(hint, V(k, v));
+					r.insert({k, v});
+					CHECK(a->first == k && a->second == r[k]);
+					last = a;
+					break;
+				}
+				case 3:
+				{
+					// Ascending run fed back through the previous result
+					int key = s.empty() ? 0 : (--s.end())->first + 1;
+					typename M::iterator hint = s.empty() ? s.end() : --s.end();
+					for (int n = Pick(rng, 20); n > 0; --n, ++key)
+					{
+						hint = s.insert(hint, V(key, v));
+						r.insert({key, v});
+					}
+					last = s.end();
+					break;
+				}
+				case 4:
+					CHECK(s.erase(k) == r.erase(k));
+					last = s.end();
+					break;
+				case 5:
+				{
+					auto i = s.find(k);
+					CHECK((i == s.end()) == (r.find(k) == r.end()));
+					if (i != s.end())
+					{
+						s.erase(i);
+						r.erase(k);
+					}
+					last = s.end();
+					break;
+				}
+				case 6:
+				{
+					int hi = k + Pick(rng, 10);
+					s.erase(s.lower_bound(k), s.upper_bound(hi));
+					r.erase(r.lower_bound(k), r.upper_bound(hi));
+					last = s.end();
+					break;
+				}
+				case 7:
+				{
+					auto i = s.lower_bound(k);
+					auto j = r.lower_bound(k);
+					CHECK((i == s.end()) == (j == r.end()));
+					if (j != r.end())
+						CHECK(i->first == j->first);
+					auto u = s.upper_bound(k);
+					auto w = r.upper_bound(k);
+					CHECK((u == s.end()) == (w == r.end()));
+					if (w != r.end())
+						CHECK(u->first == w->first);
+					CHECK(s.count(k) == r.count(k));
+					break;
+				}
+				case 8:
+					s[k] = v;
+					r[k] = v;
+					break;
+				case 9:
+				{
+					// Range construction: sorted input takes the linear bulk build, unsorted the insert loop
+					std::vector<V> src;
+					std::map<int, int> rr;
+					int n = Pick(rng, 200);
+					bool sorted = Pick(rng, 3) != 0;
+					for (int i = 0; i < n; ++i)
+					{
+						int key = sorted ? i * 3 : Pick(rng, keys);
+						src.push_back(V(key, i));
+						rr.insert({key, i});
+					}
+					M b(src.data(), src.data() + src.size());
+					s.swap(b);
+					r.swap(rr);
+					last = s.end();
+					break;
+				}
+				case 10:
+				{
+					M c(s);
+					CHECK(c._Verify() && c.size() == s.size());
+					s = c;
+					last = s.end();
+					break;
+				}
+				case 11:
+					if (Pick(rng, 30) == 0)
+					{
+						s.clear();
+						r.clear();
+						last = s.end();
+					}
+					break;
+				case 12:
+				{
+					// The tree's own iterator range insert, into an empty tree and over overlapping keys
+					typename M::_Imp t(std::less<int>(), false, A());
+					t.insert(V(k, v));
+					t.insert(s.begin(), s.end());
+					CHECK(t._Verify() && t.size() == r.size() + (r.count(k) == 0));
+					typename M::_Imp u(std::less<int>(), false, A());
+					u.insert(t.begin(), t.end());
+					CHECK(u._Verify() && u.size() == t.size() && std::equal(u.begin(), u.end(), t.begin()));
+					break;
+				}
+			}
+			same();
+		}
+	}
+
+	std::string_view View(const st6::string& s) { return st6::as_string_view(s); }
+	std::string_view View(st6::string& s) { return st6::as_string_view(s); }
+	std::u16string_view View(const st6::wstring& s) { return st6::as_u16string_view(s); }
+	std::u16string_view View(st6::wstring& s) { return st6::as_u16string_view(s); }
+
+	// st6::string against std::string, and st6::wstring, which holds player and character names, against
+	// std::u16string
+	template<class S, class C>
+	void FuzzString(Rng& rng, int steps)
+	{
+		typedef typename S::value_type E;
+		typedef std::basic_string<C> R;
+		// Printable ASCII only for char: std::string orders as unsigned char, st6 as the plain char type. Wide
+		// strings mix in Cyrillic and characters above 0x8000, which must order as unsigned.
+		auto text = [&](int n)
+		{
+			R t;
+			for (; n > 0; --n)
+			{
+				int c = 32 + Pick(rng, 95);
+				if (sizeof(E) > 1 && Pick(rng, 3) == 0)
+					c = Pick(rng, 2) ? 0x410 + Pick(rng, 64) : 0x8000 + Pick(rng, 0x7000);
+				t += (C)c;
+			}
+			return t;
+		};
+		auto p = [](const R& t) { return reinterpret_cast<const E*>(t.c_str()); };
+		auto str = [](const S& x) { return R(reinterpret_cast<const C*>(x.c_str()), x.size()); };
+		S s;
+		R r;
+		for (int step = 0; step < steps; ++step)
+		{
+			R t = text(Pick(rng, 24));
+			size_t pos = (size_t)Pick(rng, (int)r.size() + 1);
+			size_t n = (size_t)Pick(rng, 8);
+			switch (Pick(rng, 10))
+			{
+				case 0:
+					s.append(p(t), t.size());
+					r.append(t);
+					break;
+				case 1:
+					s += p(t);
+					r += t;
+					break;
+				case 2:
+					s.insert(pos, p(t));
+					r.insert(pos, t);
+					break;
+				case 3:
+					s.erase(pos, n);
+					r.erase(pos, n);
+					break;
+				case 4:
+					s.replace(pos, n, p(t));
+					r.replace(pos, n, t);
+					break;
+				case 5:
+					s.assign(p(t));
+					r.assign(t);
+					break;
+				case 6:
+				{
+					// Copy-on-write: writing through the copy must not change the source, and vice versa
+					S c(s);
+					if (!r.empty())
+					{
+						c[pos % r.size()] = '#';
+						CHECK(str(s) == r);
+						R rc = r;
+						rc[pos % r.size()] = '#';
+						CHECK(str(c) == rc);
+					}
+					s = c;
+					if (!r.empty())
+						r[pos % r.size()] = '#';
+					break;
+				}
+				case 7:
+				{
+					S o(p(t));
+					int a = s.compare(o);
+					int b = r.compare(t);
+					CHECK((a < 0) == (b < 0) && (a == 0) == (b == 0));
+					CHECK((s == o) == (r == t) && (s < o) == (r < t));
+					break;
+				}
+				case 8:
+				{
+					R needle = r.empty() || Pick(rng, 2) ? t.substr(0, n) : r.substr(pos, n);
+					size_t a = s.find(p(needle), 0, needle.size());
+					size_t b = r.find(needle);
+					CHECK((a == S::npos) == (b == R::npos));
+					if (b != R::npos)
+						CHECK(a == b);
+					break;
+				}
+				case 9:
+				{
+					// A view of a non-const string survives its former COW siblings
+					S* c = new S(s);
+					auto v = View(s);
+					delete c;
+					CHECK(v == r);
+					break;
+				}
+			}
+			CHECK(s.size() == r.size());
+			CHECK(str(s) == r);
+			CHECK(View(static_cast<const S&>(s)) == r);
+		}
+	}
+
+	// The span, view and ranges adapters against copies made the old way
+	void FuzzViews(Rng& rng, int steps)
+	{
+		st6::vector<int> empty;
+		CHECK(st6::as_span(empty).empty() && st6::as_span(static_cast<const st6::vector<int>&>(empty)).empty());
+
+		st6::list<int> l;
+		st6::map<int, int> m;
+		for (int step = 0; step < steps; ++step)
+		{
+			st6::vector<int> v;
+			std::vector<int> r;
+			for (int n = Pick(rng, 40); n > 0; --n)
+			{
+				int x = Pick(rng, 100);
+				v.push_back(x);
+				r.push_back(x);
+			}
+			std::span<int> sp = st6::as_span(v);
+			std::span<const int> csp = st6::as_span(static_cast<const st6::vector<int>&>(v));
+			CHECK(sp.data() == v.begin() && csp.data() == v.begin());
+			CHECK(std::ranges::equal(sp, r) && std::ranges::equal(csp, r));
+			if (!sp.empty())
+			{
+				// Writes through the span land in the vector
+				std::ranges::sort(sp);
+				std::ranges::sort(r);
+				SameSequence(v, r);
+			}
+
+			int k = Pick(rng, 100);
+			l.push_back(k);
+			m[k] = step;
+			std::list<int> rl(l.begin(), l.end());
+			CHECK(std::ranges::count(l, k) == std::ranges::count(rl, k));
+			CHECK(std::ranges::equal(l | std::views::reverse, rl | std::views::reverse));
+			CHECK(std::ranges::distance(m) == (std::ptrdiff_t)m.size());
+			CHECK(std::ranges::is_sorted(m | std::views::keys));
+			CHECK(std::ranges::find(m | std::views::keys, k).base()->second == step);
+		}
+
+		// st6::wstring views as char16_t, the way plugins pass character names to std code
+		for (int step = 0; step < steps; ++step)
+		{
+			std::u16string r;
+			for (int n = Pick(rng, 30); n > 0; --n)
+				r += (char16_t)(Pick(rng, 2) ? 'a' + Pick(rng, 26) : 0x400 + Pick(rng, 0x100));
+			st6::wstring s(reinterpret_cast<const unsigned short*>(r.c_str()), r.size());
+			const st6::wstring shared(s);
+			CHECK(st6::as_u16string_view(shared) == r);
+			std::u16string_view v = st6::as_u16string_view(s);
+			CHECK(v == r);
+			// Viewing the non-const copy moved it off the shared buffer
+			CHECK(r.empty() || v.data() != st6::as_u16string_view(shared).data());
+			CHECK(st6::as_u16string_view(shared) == r);
+		}
+	}
+
+	template<class E>
+	int ExactReference(const E* a, const E* b, size_t n)
+	{
+		for (size_t i = 0; i < n; ++i)
+			if (a[i] != b[i])
+				return a[i] < b[i] ? -1 : +1;
+		return 0;
+	}
+
+	template<class E>
+	E Fold(E c)
+	{
+		return c >= 'A' && c <= 'Z' ? (E)(c + 32) : c;
+	}
+
+	template<class E>
+	int FoldedReference(const E* a, const E* b, size_t n)
+	{
+		for (size_t i = 0; i < n; ++i)
+			if (Fold(a[i]) != Fold(b[i]))
+				return Fold(a[i]) < Fold(b[i]) ? -1 : +1;
+		return 0;
+	}
+
+	// char_traits::compare against the plain scalar loop it replaced, and the opt-in folded compare and hash
+	template<class E, class Tr>
+	void FuzzTraits(Rng& rng, int steps)
+	{
+		E a[80], b[80];
+		for (int step = 0; step < steps; ++step)
+		{
+			size_t n = (size_t)Pick(rng, 70);
+			for (size_t i = 0; i < n; ++i)
+			{
+				unsigned x = rng();
+				E c = (x & 3) == 0 ? (E)(x >> 8) : (E)("aAzZ@[`{09"[(x >> 4) % 10]);
+				a[i] = c;
+				// Mostly the same letters in the other case, to exercise the folded compare
+				b[i] = (x & 0x30) == 0 ? c : c >= 'a' && c <= 'z' ? (E)(c - 32) : Fold(c);
+			}
+			if (n && Pick(rng, 3) == 0)
+				b[Pick(rng, (int)n)] = (E)rng();
+			if (Pick(rng, 2))
+				for (size_t i = 0; i < n; ++i)
+					b[i] = a[i];
+			CHECK(Tr::compare(a, b, n) == ExactReference(a, b, n));
+			CHECK(st6::_Ci_compare(a, b, n) == FoldedReference(a, b, n));
+			if (FoldedReference(a, b, n) == 0)
+				CHECK(st6::_Ci_hash(a, n) == st6::_Ci_hash(b, n));
+		}
+	}
+
+	void FuzzArena(Rng& rng, int ticks)
+	{
+		st6::tick_arena& arena = st6::tick_arena::get();
+		for (int tick = 0; tick < ticks; ++tick)
+		{
+			{
+				st6::list<int, st6::arena_allocator<int>> l;
+				st6::vector<int, st6::arena_allocator<int>> v;
+				st6::map<int, int, std::less<int>, st6::arena_allocator<int>> m;
+				std::map<int, int> r;
+				for (int n = Pick(rng, 300); n > 0; --n)
+				{
+					int k = Pick(rng, 100);
+					l.push_back(k);
+					v.push_back(k);
+					m.insert(st6::map<int, int, std::less<int>, st6::arena_allocator<int>>::value_type(k, k));
+					r.insert({k, k});
+				}
+				CHECK(l._Verify() && m._Verify() && l.size() == v.size() && m.size() == r.size());
+			}
+			arena.reset();
+			CHECK(arena.counters().bytes == 0);
+		}
+		CHECK(arena.counters().backing_allocs <= 4);
+	}
+
+	// Strings and small vectors on pool_allocator: every size is rounded to a pointer-sized class, so a second round of
+	// the same allocations is served entirely from the cache
+	void FuzzPool(Rng& rng, int steps)
+	{
+		typedef st6::basic_string<char, st6::char_traits<char>, st6::pool_allocator<char>> PString;
+		typedef st6::basic_string<unsigned short, st6::char_traits<unsigned short>, st6::pool_allocator<unsigned short>> PWString;
+		const st6::alloc_counters& counters = st6::_Node_pool::_Get().counters();
+		size_t lengths[8];
+		for (size_t& n : lengths)
+			n = (size_t)Pick(rng, 200);
+		size_t backing = 0;
+		for (int round = 0; round < steps; ++round)
+		{
+			{
+				st6::vector<PString> names;
+				st6::vector<PWString> wnames;
+				st6::vector<int, st6::pool_allocator<int>> ids;
+				names.reserve(8), wnames.reserve(8);
+				for (size_t n : lengths)
+				{
+					names.push_back(PString(n, 'x'));
+					wnames.push_back(PWString(n, (unsigned short)0x442));
+					ids.push_back((int)n);
+					CHECK(names.back().size() == n && wnames.back().size() == n);
+				}
+			}
+			if (round == 0)
+				backing = counters.backing_allocs;
+			CHECK(counters.backing_allocs == backing);
+		}
+	}
+
+	void Round(unsigned seed, int steps)
+	{
+		Rng rng(seed);
+		FuzzVector<int>(rng, steps);
+		FuzzVector<Tracked>(rng, steps);
+		CHECK(Tracked::live == 0);
+		FuzzList<st6::allocator<int>>(rng, steps);
+		FuzzList<st6::node_allocator<int>>(rng, steps);
+		FuzzMap<st6::allocator<int>>(rng, steps, 200);
+		FuzzMap<st6::node_allocator<int>>(rng, steps, 50);
+		FuzzMap<st6::pool_allocator<int>>(rng, steps, 1000);
+		FuzzString<st6::string, char>(rng, steps);
+		FuzzString<st6::wstring, char16_t>(rng, steps);
+		FuzzViews(rng, steps / 10);
+		FuzzTraits<char, ci_char_traits>(rng, steps * 10);
+		FuzzTraits<unsigned short, ci_wchar_traits>(rng, steps * 10);
+		FuzzArena(rng, steps / 50 + 1);
+		FuzzPool(rng, 3);
+	}
+} // namespace
+
+int main(int argc, char** argv)
+{
+	unsigned seed = argc > 1 ? (unsigned)std::strtoul(argv[1], nullptr, 10) : 1;
+	int rounds = argc > 2 ? std::atoi(argv[2]) : 20;
+
+	for (int round = 0; round < rounds; ++round)
+		Round(seed + round, 2000);
+
+	// The tree sentinel and the node pools are shared or per-thread; hammer them from several threads at once
+	std::vector<std::thread> threads;
+	for (unsigned t = 0; t < 4; ++t)
+		threads.emplace_back(
+			[seed, t]()
+			{
+				Rng rng(seed * 31 + t);
+				FuzzMap<st6::allocator<int>>(rng, 5000, 300);
+				FuzzMap<st6::node_allocator<int>>(rng, 5000, 300);
+				FuzzList<st6::node_allocator<int>>(rng, 2000);
+			});
+	for (auto& t : threads)
+		t.join();
+
+	std::printf("st6_fuzz: %d rounds from seed %u passed\n", rounds, seed);
+	return 0;
+}
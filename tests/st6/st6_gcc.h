@@ -0,0 +1,40 @@
+#pragma once
+
+// Builds st6.h outside of MSVC/FLHook for the Linux test targets. FLHook normally provides the allocation hooks, the
+// VC6 CRT macros and the std algorithms st6.h calls unqualified.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cwchar>
+#include <iterator>
+
+#define ST6_ALLOCATION_DEFINED
+#define st6_malloc malloc
+#define st6_free free
+
+#define __cdecl
+#define _CRTIMP
+#define _TRY_BEGIN try {
+#define _CATCH_ALL \
+	}              \
+	catch (...)    \
+	{
+#define _CATCH_END }
+#define _FPOSOFF(fp) ((long)(fp).__pos)
+
+namespace st6
+{
+	using std::copy;
+	using std::copy_backward;
+	using std::equal;
+	using std::lexicographical_compare;
+
+	template<class _I, class _N>
+	void _Distance(_I _F, _I _L, _N& _R)
+	{
+		_R += (_N)std::distance(_F, _L);
+	}
+}; // namespace st6
+
+#include "../../include/FLCore/st6.h"